@@ -10,6 +10,7 @@
 #include <string.h>
 #include "BSTree.h"
 #include "mystring.h"
+#include "stats.h"
 
 #define TRUE  1
 #define FALSE 0
@@ -41,6 +42,7 @@ static listNode *newListNode(char *url)
 {
 	listNode *new = malloc(sizeof(struct listNode));
 	assert(new != NULL);
+	STATS_ADD(STAT_ALLOCS, 1);
 	new->url = mystrdup(url);
 	new->next = NULL;
 	return new;
@@ -52,6 +54,7 @@ static BSTLink newBSTNode(char *str, char *url)
 {
 	BSTLink new = malloc(sizeof(BSTNode));
 	assert(new != NULL);
+	STATS_ADD(STAT_ALLOCS, 1);
 	new->value = mystrdup(str);
 	new->urlList = newListNode(url);
 	new->left = new->right = NULL;
@@ -113,7 +116,7 @@ static void urlListInsert(BSTree t, char *url)
 	// Checks if the word already exists.
 	curr = t->urlList;
 	while (curr != NULL) {
-		if (strcmp(curr->url, url) == 0) exists = TRUE;
+		if (STATS_STRCMP(curr->url, url) == 0) exists = TRUE;
 		curr = curr->next;
 	}
 	// Iterates to the last node.
@@ -136,7 +139,7 @@ BSTree BSTreeInsert(BSTree t, char *str, char *url)
 	if (t == NULL)
 		return newBSTNode(str, url);
 
-	int v = strcmp(str, t->value);
+	int v = STATS_STRCMP(str, t->value);
 	if (v < 0)
 		t->left = BSTreeInsert(t->left, str, url);
 	else if (v > 0)
@@ -0,0 +1,227 @@
+/* aggregate.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * Each mode computes one score per URL and sorts the URLs by it:
+ *  - median: median normalised position (lower is better).
+ *  - borda:  sum of 1 - tau(u)/|tau| over the lists (higher is better),
+ *            so URLs missing from a list lose that list's points.
+ *  - markov: stationary probability of the MC4 walk (higher is better).
+ * None of them builds the n x n cost matrix, so they stay usable on
+ * merges far too large for the exact assignment.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "aggregate.h"
+#include "footrule.h"
+#include "rng.h"
+
+#define MIN(X, Y)  ( (X < Y) ? X : Y)
+#define MAX(X, Y)  ( (X > Y) ? X : Y)
+#define MC_SEED    88172645463325252ULL   // xorshift state, must not be 0
+
+typedef struct keyedURL {
+    double key;
+    int    id;
+} KeyedURL;
+
+typedef struct pairVote {
+    long pair;      // lo * n + hi with lo < hi
+    int  vote;      // +1 if the list ranks lo above hi, -1 otherwise
+} PairVote;
+
+
+static int compareKey(const void *a, const void *b)
+{
+    const KeyedURL *x = a, *y = b;
+    if (x->key < y->key) return -1;
+    if (x->key > y->key) return 1;
+    return x->id - y->id;
+}
+
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+
+static int comparePair(const void *a, const void *b)
+{
+    long x = ((const PairVote *)a)->pair, y = ((const PairVote *)b)->pair;
+    return (x > y) - (x < y);
+}
+
+
+// sorts by ascending key and gives each URL its place in that order
+static void assignByKey(KeyedURL *keys, int n, int *assign)
+{
+    int p;
+    qsort(keys, n, sizeof(KeyedURL), compareKey);
+    for (p = 0; p < n; p++) assign[keys[p].id] = p;
+}
+
+
+double medianPosition(double *norm, int nNorm, double *scratch)
+{
+    int k;
+    if (nNorm == 0) return 1.0;
+    for (k = 0; k < nNorm; k++) scratch[k] = norm[k];
+    qsort(scratch, nNorm, sizeof(double), compareDouble);
+    if (nNorm % 2 == 1) return scratch[nNorm / 2];
+    return (scratch[nNorm / 2 - 1] + scratch[nNorm / 2]) / 2;
+}
+
+
+void medianAggregate(double **norm, int *nNorm, int n, int *assign)
+{
+    KeyedURL *keys = malloc(n * sizeof(KeyedURL));
+    int u, maxNorm = 0;
+    for (u = 0; u < n; u++) if (nNorm[u] > maxNorm) maxNorm = nNorm[u];
+    double *scratch = malloc((maxNorm + 1) * sizeof(double));
+    assert(keys != NULL && scratch != NULL);
+    for (u = 0; u < n; u++) {
+        keys[u].id = u;
+        keys[u].key = medianPosition(norm[u], nNorm[u], scratch);
+    }
+    assignByKey(keys, n, assign);
+    free(scratch);
+    free(keys);
+}
+
+
+void bordaAggregate(double **norm, int *nNorm, int n, int *assign)
+{
+    KeyedURL *keys = malloc(n * sizeof(KeyedURL));
+    assert(keys != NULL);
+    int u, k;
+    for (u = 0; u < n; u++) {
+        double score = 0;
+        for (k = 0; k < nNorm[u]; k++) score += 1 - norm[u][k];
+        keys[u].id = u;
+        keys[u].key = -score;   // best score first
+    }
+    assignByKey(keys, n, assign);
+    free(keys);
+}
+
+
+/* Collects one vote per list for every compared pair, then merges the
+ * votes of each pair into a single majority edge toward the preferred
+ * URL. Returns the number of edges; from[e] -> to[e]. partners[u]
+ * counts the URLs compared with u.
+ */
+static long majorityEdges(int **lists, int *listLen, int nLists, int n,
+                          int window, int **from, int **to, int *partners)
+{
+    long nVotes = 0, cap = 0, v, e;
+    int k, a, b;
+    for (k = 0; k < nLists; k++) {
+        long len = listLen[k];
+        long w = (window <= 0 || window > len) ? len : window;
+        cap += len * w;
+    }
+    PairVote *votes = malloc((cap + 1) * sizeof(PairVote));
+    assert(votes != NULL);
+    unsigned long long rngState = MC_SEED;
+    for (k = 0; k < nLists; k++) {
+        int *list = lists[k], len = listLen[k];
+        for (a = 0; a < len; a++) {
+            int full = window <= 0 || window >= len;
+            int last = full ? len - 1 : MIN(a + window / 2, len - 1);
+            int nRandom = full ? 0 : window - window / 2;
+            for (b = a + 1; b <= last + nRandom; b++) {
+                // past the neighbours, compare with random places
+                int other = b <= last ? b : nextRandom(&rngState) % len;
+                int x = list[MIN(a, other)], y = list[MAX(a, other)];
+                if (x == y) continue;
+                // x is ranked above y
+                PairVote *pv = &votes[nVotes++];
+                if (x < y) { pv->pair = (long)x * n + y; pv->vote = 1; }
+                else       { pv->pair = (long)y * n + x; pv->vote = -1; }
+            }
+        }
+    }
+    qsort(votes, nVotes, sizeof(PairVote), comparePair);
+
+    *from = malloc((nVotes + 1) * sizeof(int));
+    *to = malloc((nVotes + 1) * sizeof(int));
+    assert(*from != NULL && *to != NULL);
+    e = 0;
+    for (v = 0; v < nVotes; ) {
+        long pair = votes[v].pair;
+        int total = 0;
+        for (; v < nVotes && votes[v].pair == pair; v++) total += votes[v].vote;
+        int lo = pair / n, hi = pair % n;
+        partners[lo]++; partners[hi]++;
+        if (total == 0) continue;
+        // the walk moves toward the URL most lists prefer
+        if (total > 0) { (*from)[e] = hi; (*to)[e] = lo; }
+        else           { (*from)[e] = lo; (*to)[e] = hi; }
+        e++;
+    }
+    free(votes);
+    return e;
+}
+
+
+void markovAggregate(int **lists, int *listLen, int nLists, int n,
+                     int window, int *assign)
+{
+    int *from, *to;
+    int *partners = calloc(n + 1, sizeof(int));
+    assert(partners != NULL);
+    long nEdges = majorityEdges(lists, listLen, nLists, n, window,
+                                &from, &to, partners);
+    double *prob = malloc(n * sizeof(double));
+    double *next = malloc(n * sizeof(double));
+    double *stay = malloc(n * sizeof(double));
+    KeyedURL *keys = malloc(n * sizeof(KeyedURL));
+    assert(prob != NULL && next != NULL && stay != NULL && keys != NULL);
+    int u, iter;
+    long e;
+    // from URL i one of the URLs compared with it is picked uniformly and
+    // the walk only moves there if the majority prefers it; with every
+    // pair compared this is the MC4 chain
+    double *step = malloc(n * sizeof(double));
+    assert(step != NULL);
+    for (u = 0; u < n; u++) {
+        prob[u] = 1.0 / n;
+        stay[u] = 1.0;
+        step[u] = partners[u] > 0 ? 1.0 / partners[u] : 0;
+    }
+    for (e = 0; e < nEdges; e++) stay[from[e]] -= step[from[e]];
+
+    for (iter = 0; iter < MC_MAX_ITER; iter++) {
+        for (u = 0; u < n; u++)
+            next[u] = (1 - MC_DAMPING) / n + MC_DAMPING * prob[u] * stay[u];
+        for (e = 0; e < nEdges; e++)
+            next[to[e]] += MC_DAMPING * prob[from[e]] * step[from[e]];
+        double diff = 0;
+        for (u = 0; u < n; u++) {
+            diff += fabs(next[u] - prob[u]);
+            prob[u] = next[u];
+        }
+        if (diff < MC_TOLERANCE) break;
+    }
+
+    for (u = 0; u < n; u++) { keys[u].id = u; keys[u].key = -prob[u]; }
+    assignByKey(keys, n, assign);
+    free(prob); free(next); free(stay); free(step); free(keys);
+    free(from); free(to); free(partners);
+}
+
+
+double footruleDistance(double **norm, int *nNorm, int n, int *assign)
+{
+    double sum = 0;
+    int u;
+    for (u = 0; u < n; u++)
+        sum += footruleCost(norm[u], nNorm[u], (assign[u] + 1) / (double)n);
+    return sum;
+}
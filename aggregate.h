@@ -0,0 +1,42 @@
+/* aggregate.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Approximate rank aggregation used by scaledFootrule when the exact
+ * footrule assignment is not worth its O(n^3) cost.
+ * URLs are numbered 0 .. n-1. norm[u] holds the nNorm[u] normalised
+ * positions tau(u)/|tau| of URL u in the lists that contain it; every
+ * mode fills assign[u] with the 0-based position given to URL u.
+ * Ties are broken by the lower URL number.
+ */
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#define MC_DAMPING      0.85    // MC4 walk follows a majority edge, else jumps
+#define MC_TOLERANCE    1e-12
+#define MC_MAX_ITER     1000
+#define MC_WINDOW       16      // default comparisons per place in markovAggregate
+
+/* median of nNorm normalised positions (1 if there are none); it is
+ * where the footrule cost of the URL is lowest. scratch holds nNorm.
+ */
+double medianPosition(double *norm, int nNorm, double *scratch);
+// orders URLs by the median of their normalised positions, O(N log N)
+void medianAggregate(double **norm, int *nNorm, int n, int *assign);
+// orders URLs by Borda score sum(1 - tau(u)/|tau|), O(N + n log n)
+void bordaAggregate(double **norm, int *nNorm, int n, int *assign);
+/* MC4: a random walk that moves from URL i to j when most of the lists
+ * ranking both put j first; URLs are ordered by its stationary
+ * distribution. lists[k] holds the listLen[k] URL numbers of list k in
+ * rank order. With window > 0 each place in a list is compared with the
+ * window/2 places below it and window/2 random places of that list,
+ * O(N * window) comparisons; window 0 compares every pair (exact MC4).
+ */
+void markovAggregate(int **lists, int *listLen, int nLists, int n,
+                     int window, int *assign);
+// scaled footrule distance of an assignment
+double footruleDistance(double **norm, int *nNorm, int n, int *assign);
+
+#endif
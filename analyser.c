@@ -0,0 +1,429 @@
+/* analyser.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * The stemmer follows M.F. Porter, "An algorithm for suffix stripping"
+ * (1980). A word is read as [C](VC)^m[V], where C and V are runs of
+ * consonants and vowels, and m is its measure. The five steps each
+ * strip or replace one suffix, most only when what is left has a large
+ * enough m. For example:
+ *      observations -> observation -> observ
+ *      relational -> relate, hopeful -> hope, caresses -> caress
+ * Only words made of a-z are stemmed, so URLs, numbers and words with
+ * other characters are indexed as they are.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "analyser.h"
+#include "hashMap.h"
+#include "mystring.h"
+
+#define TRUE        1
+#define FALSE       0
+#define MAX_WORD    1001
+#define STOP_KEYS   256
+#define STEM_KEY    "stem"
+#define STOP_KEY    "stop"
+
+struct analyser {
+    int     stem;
+    HashMap stopWords;  // NULL if none
+    char  **stopList;   // the same words in the order added, for saving
+    int     nStop;
+    int     capStop;
+};
+
+static char *defaultStopWords[] = {
+    "a", "about", "above", "after", "again", "against", "all", "am", "an",
+    "and", "any", "are", "as", "at", "be", "because", "been", "before",
+    "being", "below", "between", "both", "but", "by", "can", "could", "did",
+    "do", "does", "doing", "down", "during", "each", "few", "for", "from",
+    "further", "had", "has", "have", "having", "he", "her", "here", "hers",
+    "herself", "him", "himself", "his", "how", "i", "if", "in", "into", "is",
+    "it", "its", "itself", "just", "me", "more", "most", "my", "myself", "no",
+    "nor", "not", "now", "of", "off", "on", "once", "only", "or", "other",
+    "our", "ours", "ourselves", "out", "over", "own", "same", "she", "should",
+    "so", "some", "such", "than", "that", "the", "their", "theirs", "them",
+    "themselves", "then", "there", "these", "they", "this", "those",
+    "through", "to", "too", "under", "until", "up", "very", "was", "we",
+    "were", "what", "when", "where", "which", "while", "who", "whom", "why",
+    "will", "with", "would", "you", "your", "yours", "yourself",
+    "yourselves", NULL
+};
+
+
+// ---------------------------------------------------------------- stemmer
+
+typedef struct stem {
+    char *b;    // the word
+    int   k;    // index of its last letter
+    int   j;    // end of the stem left when a suffix matched
+} Stem;
+
+
+// TRUE if b[i] is a consonant
+static int cons(Stem *z, int i)
+{
+    switch (z->b[i]) {
+    case 'a': case 'e': case 'i': case 'o': case 'u': return FALSE;
+    case 'y': return i == 0 ? TRUE : !cons(z, i - 1);
+    default: return TRUE;
+    }
+}
+
+
+// m, the number of VC sequences in b[0 .. j]
+static int measure(Stem *z)
+{
+    int n = 0, i = 0;
+    while (TRUE) {
+        if (i > z->j) return n;
+        if (!cons(z, i)) break;
+        i++;
+    }
+    i++;
+    while (TRUE) {
+        while (TRUE) {
+            if (i > z->j) return n;
+            if (cons(z, i)) break;
+            i++;
+        }
+        i++;
+        n++;
+        while (TRUE) {
+            if (i > z->j) return n;
+            if (!cons(z, i)) break;
+            i++;
+        }
+        i++;
+    }
+}
+
+
+// TRUE if b[0 .. j] contains a vowel
+static int vowelInStem(Stem *z)
+{
+    int i;
+    for (i = 0; i <= z->j; i++) if (!cons(z, i)) return TRUE;
+    return FALSE;
+}
+
+
+// TRUE if b[i - 1 .. i] is a double consonant
+static int doubleCons(Stem *z, int i)
+{
+    if (i < 1 || z->b[i] != z->b[i - 1]) return FALSE;
+    return cons(z, i);
+}
+
+
+/* TRUE if b[i - 2 .. i] is consonant-vowel-consonant and the last is
+ * not w, x or y: the short syllable of hop(e) or cav(e).
+ */
+static int cvc(Stem *z, int i)
+{
+    if (i < 2 || !cons(z, i) || cons(z, i - 1) || !cons(z, i - 2)) return FALSE;
+    char c = z->b[i];
+    return c != 'w' && c != 'x' && c != 'y';
+}
+
+
+// TRUE if b[0 .. k] ends with s, setting j to the end of the stem
+static int ends(Stem *z, char *s)
+{
+    int len = strlen(s);
+    if (len > z->k + 1) return FALSE;
+    if (memcmp(z->b + z->k - len + 1, s, len) != 0) return FALSE;
+    z->j = z->k - len;
+    return TRUE;
+}
+
+
+// replaces b[j + 1 .. k] with s
+static void setTo(Stem *z, char *s)
+{
+    int len = strlen(s);
+    memcpy(z->b + z->j + 1, s, len);
+    z->k = z->j + len;
+}
+
+
+static void replaceIf(Stem *z, char *s)
+{
+    if (measure(z) > 0) setTo(z, s);
+}
+
+
+// plurals and -ed or -ing: caresses -> caress, ponies -> poni, hopping -> hop
+static void step1ab(Stem *z)
+{
+    if (z->b[z->k] == 's') {
+        if (ends(z, "sses")) z->k -= 2;
+        else if (ends(z, "ies")) setTo(z, "i");
+        else if (z->b[z->k - 1] != 's') z->k--;
+    }
+    if (ends(z, "eed")) {
+        if (measure(z) > 0) z->k--;
+    } else if ((ends(z, "ed") || ends(z, "ing")) && vowelInStem(z)) {
+        z->k = z->j;
+        if (ends(z, "at")) setTo(z, "ate");
+        else if (ends(z, "bl")) setTo(z, "ble");
+        else if (ends(z, "iz")) setTo(z, "ize");
+        else if (doubleCons(z, z->k)) {
+            char c = z->b[z->k];
+            if (c != 'l' && c != 's' && c != 'z') z->k--;
+        } else if (measure(z) == 1 && cvc(z, z->k)) {
+            z->j = z->k;
+            setTo(z, "e");
+        }
+    }
+}
+
+
+// terminal y -> i when there is another vowel: happy -> happi
+static void step1c(Stem *z)
+{
+    if (ends(z, "y") && vowelInStem(z)) z->b[z->k] = 'i';
+}
+
+
+// double suffixes to single ones: relational -> relate
+static void step2(Stem *z)
+{
+    if (z->k < 1) return;
+    switch (z->b[z->k - 1]) {
+    case 'a':
+        if (ends(z, "ational")) { replaceIf(z, "ate"); break; }
+        if (ends(z, "tional")) { replaceIf(z, "tion"); break; }
+        break;
+    case 'c':
+        if (ends(z, "enci")) { replaceIf(z, "ence"); break; }
+        if (ends(z, "anci")) { replaceIf(z, "ance"); break; }
+        break;
+    case 'e':
+        if (ends(z, "izer")) { replaceIf(z, "ize"); break; }
+        break;
+    case 'l':
+        if (ends(z, "bli")) { replaceIf(z, "ble"); break; }
+        if (ends(z, "alli")) { replaceIf(z, "al"); break; }
+        if (ends(z, "entli")) { replaceIf(z, "ent"); break; }
+        if (ends(z, "eli")) { replaceIf(z, "e"); break; }
+        if (ends(z, "ousli")) { replaceIf(z, "ous"); break; }
+        break;
+    case 'o':
+        if (ends(z, "ization")) { replaceIf(z, "ize"); break; }
+        if (ends(z, "ation")) { replaceIf(z, "ate"); break; }
+        if (ends(z, "ator")) { replaceIf(z, "ate"); break; }
+        break;
+    case 's':
+        if (ends(z, "alism")) { replaceIf(z, "al"); break; }
+        if (ends(z, "iveness")) { replaceIf(z, "ive"); break; }
+        if (ends(z, "fulness")) { replaceIf(z, "ful"); break; }
+        if (ends(z, "ousness")) { replaceIf(z, "ous"); break; }
+        break;
+    case 't':
+        if (ends(z, "aliti")) { replaceIf(z, "al"); break; }
+        if (ends(z, "iviti")) { replaceIf(z, "ive"); break; }
+        if (ends(z, "biliti")) { replaceIf(z, "ble"); break; }
+        break;
+    case 'g':
+        if (ends(z, "logi")) { replaceIf(z, "log"); break; }
+        break;
+    }
+}
+
+
+// -ic-, -full, -ness etc.: hopeful -> hope, goodness -> good
+static void step3(Stem *z)
+{
+    switch (z->b[z->k]) {
+    case 'e':
+        if (ends(z, "icate")) { replaceIf(z, "ic"); break; }
+        if (ends(z, "ative")) { replaceIf(z, ""); break; }
+        if (ends(z, "alize")) { replaceIf(z, "al"); break; }
+        break;
+    case 'i':
+        if (ends(z, "iciti")) { replaceIf(z, "ic"); break; }
+        break;
+    case 'l':
+        if (ends(z, "ical")) { replaceIf(z, "ic"); break; }
+        if (ends(z, "ful")) { replaceIf(z, ""); break; }
+        break;
+    case 's':
+        if (ends(z, "ness")) { replaceIf(z, ""); break; }
+        break;
+    }
+}
+
+
+// -ant, -ence etc. when m > 1: adjustment -> adjust
+static void step4(Stem *z)
+{
+    if (z->k < 1) return;
+    switch (z->b[z->k - 1]) {
+    case 'a': if (ends(z, "al")) break; return;
+    case 'c': if (ends(z, "ance") || ends(z, "ence")) break; return;
+    case 'e': if (ends(z, "er")) break; return;
+    case 'i': if (ends(z, "ic")) break; return;
+    case 'l': if (ends(z, "able") || ends(z, "ible")) break; return;
+    case 'n':
+        if (ends(z, "ant") || ends(z, "ement") || ends(z, "ment") || ends(z, "ent"))
+            break;
+        return;
+    case 'o':
+        if (ends(z, "ion") && z->j >= 0 && (z->b[z->j] == 's' || z->b[z->j] == 't'))
+            break;
+        if (ends(z, "ou")) break;
+        return;
+    case 's': if (ends(z, "ism")) break; return;
+    case 't': if (ends(z, "ate") || ends(z, "iti")) break; return;
+    case 'u': if (ends(z, "ous")) break; return;
+    case 'v': if (ends(z, "ive")) break; return;
+    case 'z': if (ends(z, "ize")) break; return;
+    default: return;
+    }
+    if (measure(z) > 1) z->k = z->j;
+}
+
+
+// final -e and -ll: probate -> probat, controll -> control
+static void step5(Stem *z)
+{
+    z->j = z->k;
+    if (z->b[z->k] == 'e') {
+        int m = measure(z);
+        if (m > 1 || (m == 1 && !cvc(z, z->k - 1))) z->k--;
+    }
+    if (z->b[z->k] == 'l' && doubleCons(z, z->k) && measure(z) > 1) z->k--;
+}
+
+
+// stems word (len letters a-z) in place, returns the new length
+static int porterStem(char *word, int len)
+{
+    if (len <= 2) return len;
+    Stem z = { word, len - 1, 0 };
+    step1ab(&z);
+    if (z.k > 0) {
+        step1c(&z);
+        step2(&z);
+        step3(&z);
+        step4(&z);
+        step5(&z);
+    }
+    word[z.k + 1] = '\0';
+    return z.k + 1;
+}
+
+
+// -------------------------------------------------------------- analyser
+
+static void addStopWord(Analyser a, char *word)
+{
+    if (a->stopWords == NULL) a->stopWords = newHashMap(STOP_KEYS);
+    if (hashMapGet(a->stopWords, word) != NOT_FOUND) return;
+    hashMapPut(a->stopWords, word, TRUE);
+    if (a->nStop == a->capStop) {
+        a->capStop = a->capStop == 0 ? STOP_KEYS : 2 * a->capStop;
+        a->stopList = realloc(a->stopList, a->capStop * sizeof(char *));
+        assert(a->stopList != NULL);
+    }
+    a->stopList[a->nStop++] = mystrdup(word);
+}
+
+
+Analyser newAnalyser(int stem, char *stopFile)
+{
+    Analyser a = calloc(1, sizeof(struct analyser));
+    assert(a != NULL);
+    a->stem = stem;
+    if (stopFile == NULL) return a;
+    int i;
+    if (strcmp(stopFile, DEFAULT_STOP) == 0) {
+        for (i = 0; defaultStopWords[i] != NULL; i++)
+            addStopWord(a, defaultStopWords[i]);
+        return a;
+    }
+    FILE *file = fopen(stopFile, "r");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    char word[MAX_WORD];
+    while (fscanf(file, "%1000s", word) == 1) {
+        for (i = 0; word[i] != '\0'; i++) word[i] = tolower(word[i]);
+        addStopWord(a, word);
+    }
+    fclose(file);
+    return a;
+}
+
+
+void freeAnalyser(Analyser a)
+{
+    if (a == NULL) return;
+    if (a->stopWords != NULL) disposeHashMap(a->stopWords);
+    int i;
+    for (i = 0; i < a->nStop; i++) free(a->stopList[i]);
+    free(a->stopList);
+    free(a);
+}
+
+
+/* Writes the settings, one per line:
+ *  stem 0|1
+ *  stop word       (once per stop word)
+ */
+void saveAnalyser(Analyser a)
+{
+    FILE *file = fopen(ANALYSIS_FILE, "w");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    fprintf(file, "%s %d\n", STEM_KEY, a->stem);
+    int i;
+    for (i = 0; i < a->nStop; i++)
+        fprintf(file, "%s %s\n", STOP_KEY, a->stopList[i]);
+    fclose(file);
+}
+
+
+Analyser loadAnalyser()
+{
+    return readAnalyser(ANALYSIS_FILE);
+}
+
+
+Analyser readAnalyser(char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return NULL;
+    Analyser a = newAnalyser(FALSE, NULL);
+    char key[MAX_WORD], value[MAX_WORD];
+    while (fscanf(file, "%1000s %1000s", key, value) == 2) {
+        if (strcmp(key, STEM_KEY) == 0) a->stem = atoi(value);
+        else if (strcmp(key, STOP_KEY) == 0) addStopWord(a, value);
+    }
+    fclose(file);
+    return a;
+}
+
+
+void clearAnalyser()
+{
+    remove(ANALYSIS_FILE);
+}
+
+
+int analyseWord(Analyser a, char *word, int len)
+{
+    if (a == NULL || len == 0) return len;
+    if (a->stopWords != NULL && hashMapGet(a->stopWords, word) != NOT_FOUND) {
+        word[0] = '\0';
+        return 0;
+    }
+    if (!a->stem) return len;
+    int i;
+    for (i = 0; i < len; i++) if (word[i] < 'a' || word[i] > 'z') return len;
+    return porterStem(word, len);
+}
@@ -0,0 +1,41 @@
+/* analyser.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Optional analysis of normalised words: stop-word removal and Porter
+ * stemming. invertedIndex records the settings it indexed with in
+ * ANALYSIS_FILE, and the search tools load them from there so queries
+ * are analysed exactly the same way as the pages.
+ */
+
+#ifndef ANALYSER_H
+#define ANALYSER_H
+
+#define ANALYSIS_FILE   "analysis.txt"
+#define DEFAULT_STOP    "default"   // stop file name selecting the built-in list
+
+typedef struct analyser *Analyser;
+
+/* stem: apply the Porter stemmer. stopFile: NULL for no stop words,
+ * DEFAULT_STOP for the built-in English list, or a file of words
+ * separated by white space.
+ */
+Analyser newAnalyser(int stem, char *stopFile);
+void freeAnalyser(Analyser);
+// writes the settings to ANALYSIS_FILE
+void saveAnalyser(Analyser);
+// settings from ANALYSIS_FILE, or NULL (no analysis) if there is none
+Analyser loadAnalyser();
+// settings from a file written by saveAnalyser, or NULL if it does not exist
+Analyser readAnalyser(char *fileName);
+// removes ANALYSIS_FILE, for an index built without analysis
+void clearAnalyser();
+
+/* Analyses the normalised word in place (len chars, NUL-terminated).
+ * Returns its new length, or 0 if it is a stop word. A NULL analyser
+ * leaves the word alone.
+ */
+int analyseWord(Analyser, char *word, int len);
+
+#endif
@@ -0,0 +1,492 @@
+/* assignment.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * THE HUNGARIAN ALGORITHM (shortest augmenting paths):
+ * Keep potentials u (rows) and v (cols) with cost[i][j] - u[i] - v[j] >= 0
+ * and zero on every matched pair.
+ * For each row in turn:
+ * 1. Grow a Dijkstra-like tree of alternating paths from the new row,
+ *    using reduced costs as edge lengths.
+ * 2. Each step adds the column with the smallest reduced distance and
+ *    shifts the potentials of the tree by that distance, which keeps
+ *    all reduced costs non-negative.
+ * 3. Stop at the first free column and flip the path: one more row is
+ *    matched and the matching stays optimal for the rows seen so far.
+ * Every row costs O(nRows * nCols), so the whole solve is O(n^3).
+ * The potentials and matching can be kept: after some rows' costs
+ * change, only those rows are unmatched and augmented again, with their
+ * u lowered so that their reduced costs are non-negative.
+ *
+ * THE AUCTION ALGORITHM (Bertsekas, Jacobi bidding, epsilon scaling):
+ * Columns carry prices; a row's value for column j is -cost[i][j] - p[j].
+ * Each round:
+ * 1. Every unassigned row finds its best and second best column and bids
+ *    the best column's price plus the difference plus eps. Rows only read
+ *    the cost matrix and the prices, so the bids are split across threads:
+ *    by rows while there are at least as many bidders as threads, and in
+ *    the tail of each phase, when only a few rows are left, by columns,
+ *    each thread scanning a slice of every bidder's row. Rounds too small
+ *    to pay for waking the threads are bid on one.
+ * 2. Each column bid on goes to its highest bidder at that price; the
+ *    row holding it before becomes unassigned again. This is O(bidders)
+ *    against O(bidders * n) for the bids, so it stays on one thread.
+ * Every row ends within eps of its best value, so the total is within
+ * n * eps of the optimum. A large eps settles quickly but roughly; the
+ * prices it leaves behind are kept while eps is cut down to the target,
+ * so the later phases only make small corrections.
+ *
+ * BANDED ASSIGNMENT (sparse shortest augmenting paths):
+ * The same potentials as the Hungarian algorithm, but row i may only take
+ * the width columns from bandStart[i]. The tree is grown with Dijkstra
+ * over a binary heap of columns, so a row costs O(E log E) in the edges
+ * it reaches instead of O(n) per step, and only the band is stored.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <assert.h>
+#include <pthread.h>
+#include "assignment.h"
+
+#define TRUE        1
+#define FALSE       0
+#define UNMATCHED   0   // rows and columns are numbered from 1 below
+#define UNASSIGNED  -1  // auction rows and columns are numbered from 0
+#define EPS_SCALE   7   // eps is divided by this between auction phases
+#define MAX_THREADS 256
+#define SERIAL_WORK 32768   // rounds with fewer bidders * n are bid on one thread
+
+typedef struct auction {
+    double *cost;
+    int     n;
+    double  eps;
+    double *price;
+    int    *bidders;        // unassigned rows bidding this round
+    int     nBidders;
+    int    *bidCol;         // column and amount of bidders[k]'s bid
+    double *bidAmount;
+    int     splitCols;      // TRUE when the threads split columns, not rows
+    double *partBest;       // best, second best and best column of bidder
+    double *partSecond;     // k in slice t, at k * nThreads + t
+    int    *partCol;
+    int     nThreads;
+    int     done;
+    pthread_barrier_t start;
+    pthread_barrier_t finish;
+} Auction;
+
+typedef struct heapEntry {
+    double dist;
+    int    col;
+} HeapEntry;
+
+typedef struct bidWorker {
+    Auction *a;
+    int      id;
+} BidWorker;
+
+
+AssignState newAssignState(int nRows, int nCols)
+{
+    assert(nRows <= nCols);
+    AssignState state = malloc(sizeof(struct assignState));
+    assert(state != NULL);
+    state->nRows = nRows;
+    state->nCols = nCols;
+    // index 0 is a virtual column/row used as the root of each search
+    state->u = calloc(nRows + 1, sizeof(double));
+    state->v = calloc(nCols + 1, sizeof(double));
+    state->rowOf = calloc(nCols + 1, sizeof(int));  // row matched to column j
+    assert(state->u != NULL && state->v != NULL && state->rowOf != NULL);
+    return state;
+}
+
+
+void freeAssignState(AssignState state)
+{
+    if (state == NULL) return;
+    free(state->u); free(state->v); free(state->rowOf);
+    free(state);
+}
+
+
+void resetAssignRow(AssignState state, double *cost, int row)
+{
+    int j, nCols = state->nCols;
+    double *costRow = cost + (long)row * nCols - 1;     // 1-based
+    double lowest = DBL_MAX;
+    for (j = 1; j <= nCols; j++) {
+        if (state->rowOf[j] == row + 1) state->rowOf[j] = UNMATCHED;
+        if (costRow[j] - state->v[j] < lowest) lowest = costRow[j] - state->v[j];
+    }
+    state->u[row + 1] = lowest;
+}
+
+
+double hungarianSolve(AssignState state, double *cost, int *rowAssign)
+{
+    int nRows = state->nRows, nCols = state->nCols;
+    double *u = state->u, *v = state->v;
+    int *rowOf = state->rowOf;
+    double *minDist = malloc((nCols + 1) * sizeof(double));
+    int *way = calloc(nCols + 1, sizeof(int));    // previous column on the path
+    char *used = malloc((nCols + 1) * sizeof(char));
+    char *matched = calloc(nRows + 1, sizeof(char));
+    assert(minDist != NULL && way != NULL && used != NULL && matched != NULL);
+
+    int i, j;
+    for (j = 1; j <= nCols; j++) matched[rowOf[j]] = TRUE;
+    for (i = 1; i <= nRows; i++) {
+        if (matched[i]) continue;
+        rowOf[0] = i;
+        int col = 0;
+        for (j = 0; j <= nCols; j++) { minDist[j] = DBL_MAX; used[j] = FALSE; }
+        // Grow the tree until a free column is reached.
+        do {
+            used[col] = TRUE;
+            int row = rowOf[col], nextCol = 0;
+            double *costRow = cost + (long)(row - 1) * nCols - 1;  // 1-based
+            double delta = DBL_MAX;
+            for (j = 1; j <= nCols; j++) {
+                if (used[j]) continue;
+                double reduced = costRow[j] - u[row] - v[j];
+                if (reduced < minDist[j]) { minDist[j] = reduced; way[j] = col; }
+                if (minDist[j] < delta) { delta = minDist[j]; nextCol = j; }
+            }
+            for (j = 0; j <= nCols; j++) {
+                if (used[j]) { u[rowOf[j]] += delta; v[j] -= delta; }
+                else minDist[j] -= delta;
+            }
+            col = nextCol;
+        } while (rowOf[col] != UNMATCHED);
+        // Flip the alternating path back to the root.
+        do {
+            int prev = way[col];
+            rowOf[col] = rowOf[prev];
+            col = prev;
+        } while (col != 0);
+    }
+    rowOf[0] = UNMATCHED;
+
+    double total = 0;
+    for (j = 1; j <= nCols; j++) {
+        if (rowOf[j] == UNMATCHED) continue;
+        rowAssign[rowOf[j] - 1] = j - 1;
+        total += cost[(long)(rowOf[j] - 1) * nCols + j - 1];
+    }
+    free(minDist); free(way); free(used); free(matched);
+    return total;
+}
+
+
+double hungarian(double *cost, int nRows, int nCols, int *rowAssign)
+{
+    AssignState state = newAssignState(nRows, nCols);
+    double total = hungarianSolve(state, cost, rowAssign);
+    freeAssignState(state);
+    return total;
+}
+
+// bids of bidders[k] for k = id, id + nThreads, ...
+static void makeBids(Auction *a, int id, int nThreads)
+{
+    int n = a->n, k, j;
+    double *price = a->price;
+    for (k = id; k < a->nBidders; k += nThreads) {
+        double *row = a->cost + (long)a->bidders[k] * n;
+        double best = -DBL_MAX, second = -DBL_MAX;
+        int bestCol = 0;
+        for (j = 0; j < n; j++) {
+            double value = -row[j] - price[j];
+            if (value > best) { second = best; best = value; bestCol = j; }
+            else if (value > second) second = value;
+        }
+        // a single column has no competitor, bid just eps over its price
+        if (second == -DBL_MAX) second = best;
+        a->bidCol[k] = bestCol;
+        a->bidAmount[k] = price[bestCol] + (best - second) + a->eps;
+    }
+}
+
+
+// best and second best of every bidder over columns slice id of nThreads
+static void makeColumnBids(Auction *a, int id, int nThreads)
+{
+    int n = a->n, k, j;
+    int lo = (long)n * id / nThreads, hi = (long)n * (id + 1) / nThreads;
+    double *price = a->price;
+    for (k = 0; k < a->nBidders; k++) {
+        double *row = a->cost + (long)a->bidders[k] * n;
+        double best = -DBL_MAX, second = -DBL_MAX;
+        int bestCol = lo;
+        for (j = lo; j < hi; j++) {
+            double value = -row[j] - price[j];
+            if (value > best) { second = best; best = value; bestCol = j; }
+            else if (value > second) second = value;
+        }
+        a->partBest[k * nThreads + id] = best;
+        a->partSecond[k * nThreads + id] = second;
+        a->partCol[k * nThreads + id] = bestCol;
+    }
+}
+
+
+/* Combines the slices in column order, which picks the same column and
+ * second best as makeBids scanning the whole row.
+ */
+static void mergeColumnBids(Auction *a)
+{
+    int k, t, nThreads = a->nThreads;
+    for (k = 0; k < a->nBidders; k++) {
+        double best = -DBL_MAX, second = -DBL_MAX;
+        int bestCol = 0;
+        for (t = 0; t < nThreads; t++) {
+            double partBest = a->partBest[k * nThreads + t];
+            double partSecond = a->partSecond[k * nThreads + t];
+            if (partBest > best) {
+                second = best > partSecond ? best : partSecond;
+                best = partBest;
+                bestCol = a->partCol[k * nThreads + t];
+            } else if (partBest > second) {
+                second = partBest;
+            }
+        }
+        if (second == -DBL_MAX) second = best;
+        a->bidCol[k] = bestCol;
+        a->bidAmount[k] = a->price[bestCol] + (best - second) + a->eps;
+    }
+}
+
+
+static void *bidThread(void *arg)
+{
+    BidWorker *w = arg;
+    Auction *a = w->a;
+    while (TRUE) {
+        pthread_barrier_wait(&a->start);
+        if (a->done) break;
+        if (a->splitCols) makeColumnBids(a, w->id, a->nThreads);
+        else makeBids(a, w->id, a->nThreads);
+        pthread_barrier_wait(&a->finish);
+    }
+    return NULL;
+}
+
+
+double auction(double *cost, int n, double eps, int nThreads, int *rowAssign)
+{
+    if (!(eps > 0)) return INFEASIBLE;
+    if (nThreads < 1) nThreads = 1;
+    if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+    Auction a = { .cost = cost, .n = n, .nThreads = nThreads, .done = FALSE };
+    a.price = calloc(n + 1, sizeof(double));
+    a.bidders = malloc((n + 1) * sizeof(int));
+    a.bidCol = malloc((n + 1) * sizeof(int));
+    a.bidAmount = malloc((n + 1) * sizeof(double));
+    int *colOwner = malloc((n + 1) * sizeof(int));
+    int *winner = malloc((n + 1) * sizeof(int));     // best bid index per column
+    int *nextBidders = malloc((n + 1) * sizeof(int));
+    // column slices are only used with fewer bidders than threads
+    a.partBest = malloc((long)nThreads * nThreads * sizeof(double));
+    a.partSecond = malloc((long)nThreads * nThreads * sizeof(double));
+    a.partCol = malloc((long)nThreads * nThreads * sizeof(int));
+    assert(a.price != NULL && a.bidders != NULL && a.bidCol != NULL);
+    assert(a.bidAmount != NULL && colOwner != NULL && winner != NULL);
+    assert(nextBidders != NULL && a.partBest != NULL && a.partSecond != NULL);
+    assert(a.partCol != NULL);
+
+    pthread_t threads[MAX_THREADS];
+    BidWorker workers[MAX_THREADS];
+    int t, i, j;
+    long k;
+    pthread_barrier_init(&a.start, NULL, nThreads);
+    pthread_barrier_init(&a.finish, NULL, nThreads);
+    for (t = 1; t < nThreads; t++) {
+        workers[t].a = &a;
+        workers[t].id = t;
+        pthread_create(&threads[t], NULL, bidThread, &workers[t]);
+    }
+
+    // eps starts at half the cost range and is scaled down to the target
+    double lo = DBL_MAX, hi = -DBL_MAX;
+    for (k = 0; k < (long)n * n; k++) {
+        if (cost[k] < lo) lo = cost[k];
+        if (cost[k] > hi) hi = cost[k];
+    }
+    a.eps = (hi - lo) / 2;
+    if (a.eps < eps) a.eps = eps;
+    while (TRUE) {
+        for (i = 0; i < n; i++) { rowAssign[i] = UNASSIGNED; a.bidders[i] = i; }
+        for (j = 0; j < n; j++) { colOwner[j] = UNASSIGNED; winner[j] = UNASSIGNED; }
+        a.nBidders = n;
+        while (a.nBidders > 0) {
+            if (nThreads > 1 && (long)a.nBidders * n >= SERIAL_WORK) {
+                a.splitCols = a.nBidders < nThreads;
+                pthread_barrier_wait(&a.start);
+                if (a.splitCols) makeColumnBids(&a, 0, nThreads);
+                else makeBids(&a, 0, nThreads);
+                pthread_barrier_wait(&a.finish);
+                if (a.splitCols) mergeColumnBids(&a);
+            } else {
+                makeBids(&a, 0, 1);
+            }
+            // each column goes to its highest bid
+            for (k = 0; k < a.nBidders; k++) {
+                j = a.bidCol[k];
+                if (winner[j] == UNASSIGNED || a.bidAmount[k] > a.bidAmount[winner[j]])
+                    winner[j] = k;
+            }
+            int nLeft = 0;
+            for (k = 0; k < a.nBidders; k++) {
+                j = a.bidCol[k];
+                if (winner[j] != k) {
+                    nextBidders[nLeft++] = a.bidders[k];
+                    continue;
+                }
+                // the row holding the column before has to bid again
+                if (colOwner[j] != UNASSIGNED) {
+                    rowAssign[colOwner[j]] = UNASSIGNED;
+                    nextBidders[nLeft++] = colOwner[j];
+                }
+                colOwner[j] = a.bidders[k];
+                rowAssign[a.bidders[k]] = j;
+                a.price[j] = a.bidAmount[k];
+            }
+            for (k = 0; k < a.nBidders; k++) winner[a.bidCol[k]] = UNASSIGNED;
+            int *swap = a.bidders;
+            a.bidders = nextBidders;
+            nextBidders = swap;
+            a.nBidders = nLeft;
+        }
+        if (a.eps <= eps) break;
+        a.eps /= EPS_SCALE;
+        if (a.eps < eps) a.eps = eps;
+    }
+
+    a.done = TRUE;
+    if (nThreads > 1) pthread_barrier_wait(&a.start);
+    for (t = 1; t < nThreads; t++) pthread_join(threads[t], NULL);
+    pthread_barrier_destroy(&a.start);
+    pthread_barrier_destroy(&a.finish);
+
+    double total = 0;
+    for (i = 0; i < n; i++) total += cost[(long)i * n + rowAssign[i]];
+    free(a.price); free(a.bidders); free(a.bidCol); free(a.bidAmount);
+    free(colOwner); free(winner); free(nextBidders);
+    free(a.partBest); free(a.partSecond); free(a.partCol);
+    return total;
+}
+
+
+static void heapPush(HeapEntry *heap, int *size, double dist, int col)
+{
+    int k = (*size)++;
+    while (k > 0 && heap[(k - 1) / 2].dist > dist) {
+        heap[k] = heap[(k - 1) / 2];
+        k = (k - 1) / 2;
+    }
+    heap[k].dist = dist;
+    heap[k].col = col;
+}
+
+
+static HeapEntry heapPop(HeapEntry *heap, int *size)
+{
+    HeapEntry top = heap[0], last = heap[--(*size)];
+    int k = 0;
+    while (2 * k + 1 < *size) {
+        int child = 2 * k + 1;
+        if (child + 1 < *size && heap[child + 1].dist < heap[child].dist) child++;
+        if (heap[child].dist >= last.dist) break;
+        heap[k] = heap[child];
+        k = child;
+    }
+    heap[k] = last;
+    return top;
+}
+
+
+double bandedAssignment(double *band, int *bandStart, int width, int n,
+                        int *rowAssign, double *u, double *v)
+{
+    double *dist = malloc((n + 1) * sizeof(double));
+    int *rowOf = malloc((n + 1) * sizeof(int));
+    int *way = malloc((n + 1) * sizeof(int));       // previous column, or -1 for the root
+    char *done = calloc(n + 1, sizeof(char));
+    int *touched = malloc((n + 1) * sizeof(int));
+    long heapCap = (long)(n + 1) * width;
+    HeapEntry *heap = malloc(heapCap * sizeof(HeapEntry));
+    assert(dist != NULL && rowOf != NULL);
+    assert(way != NULL && done != NULL && touched != NULL && heap != NULL);
+
+    int i, j, k, root;
+    for (j = 0; j < n; j++) {
+        dist[j] = DBL_MAX;
+        rowOf[j] = UNASSIGNED;
+        u[j] = v[j] = 0;
+    }
+    for (root = 0; root < n; root++) {
+        int nTouched = 0, heapSize = 0, freeCol = UNASSIGNED;
+        double *costRow = band + (long)root * width - bandStart[root];
+        for (j = bandStart[root]; j < bandStart[root] + width; j++) {
+            dist[j] = costRow[j] - u[root] - v[j];
+            way[j] = -1;
+            touched[nTouched++] = j;
+            heapPush(heap, &heapSize, dist[j], j);
+        }
+        // Dijkstra over columns until a free one is reached
+        while (heapSize > 0) {
+            HeapEntry top = heapPop(heap, &heapSize);
+            j = top.col;
+            if (done[j] || top.dist > dist[j]) continue;
+            done[j] = TRUE;
+            if (rowOf[j] == UNASSIGNED) { freeCol = j; break; }
+            i = rowOf[j];
+            costRow = band + (long)i * width - bandStart[i];
+            for (k = bandStart[i]; k < bandStart[i] + width; k++) {
+                if (done[k]) continue;
+                double d = dist[j] + costRow[k] - u[i] - v[k];
+                if (d < dist[k]) {
+                    if (dist[k] == DBL_MAX) touched[nTouched++] = k;
+                    dist[k] = d;
+                    way[k] = j;
+                    heapPush(heap, &heapSize, d, k);
+                }
+            }
+        }
+        if (freeCol == UNASSIGNED) {
+            free(dist); free(rowOf); free(way); free(done);
+            free(touched); free(heap);
+            return INFEASIBLE;
+        }
+        // shift the potentials of the tree, keeping reduced costs >= 0
+        double reach = dist[freeCol];
+        u[root] += reach;
+        for (k = 0; k < nTouched; k++) {
+            j = touched[k];
+            if (done[j] && j != freeCol) {
+                u[rowOf[j]] += reach - dist[j];
+                v[j] -= reach - dist[j];
+            }
+            dist[j] = DBL_MAX;
+            done[j] = FALSE;
+        }
+        // flip the alternating path back to the root
+        for (j = freeCol; way[j] != -1; j = way[j]) rowOf[j] = rowOf[way[j]];
+        rowOf[j] = root;
+    }
+
+    double total = 0;
+    for (j = 0; j < n; j++) {
+        i = rowOf[j];
+        rowAssign[i] = j;
+        total += band[(long)i * width + j - bandStart[i]];
+    }
+    free(dist); free(rowOf); free(way); free(done);
+    free(touched); free(heap);
+    return total;
+}
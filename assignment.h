@@ -0,0 +1,71 @@
+/* assignment.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Solvers for the assignment problem used by scaledFootrule.
+ */
+
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#define INFEASIBLE  -1.0
+
+/* Potentials and matching of a Hungarian solve, 1-based (index 0 is
+ * the virtual root): u[1..nRows], v[1..nCols], rowOf[j] the row + 1
+ * matched to column j - 1, or 0.
+ */
+struct assignState {
+    int     nRows;
+    int     nCols;
+    double *u;
+    double *v;
+    int    *rowOf;
+};
+
+typedef struct assignState *AssignState;
+
+/* Minimum cost assignment of nRows rows to distinct columns
+ * (nRows <= nCols) of a row-major nRows x nCols cost matrix, using
+ * shortest augmenting paths with dual potentials (Kuhn-Munkres,
+ * O(nRows^2 * nCols)).
+ * rowAssign[r] receives the column given to row r.
+ * Returns the total cost of the assignment.
+ */
+double hungarian(double *cost, int nRows, int nCols, int *rowAssign);
+
+// empty state: no rows matched, zero potentials
+AssignState newAssignState(int nRows, int nCols);
+void freeAssignState(AssignState);
+/* The costs of row (0-based) changed: unmatches it and lowers its
+ * potential so the state is valid for the new costs. Square only.
+ */
+void resetAssignRow(AssignState, double *cost, int row);
+/* Matches every unmatched row, resuming from state, which is updated.
+ * With k rows unmatched it costs O(k * nRows * nCols).
+ */
+double hungarianSolve(AssignState, double *cost, int *rowAssign);
+
+/* eps-optimal assignment of the rows of a row-major n x n cost matrix
+ * by the auction algorithm with eps scaling; the bids of each round are
+ * computed on nThreads threads. The total is at most n * eps above the
+ * optimum. rowAssign[r] receives the column given to row r.
+ * Returns the total cost of the assignment, or INFEASIBLE if eps is not
+ * greater than 0, as the eps scaling would never reach it.
+ */
+double auction(double *cost, int n, double eps, int nThreads, int *rowAssign);
+
+/* Minimum cost assignment when row i may only take the columns
+ * bandStart[i] .. bandStart[i] + width - 1 of n; band is row-major
+ * n x width with band[i * width + j - bandStart[i]] the cost of column j.
+ * Sparse shortest augmenting paths, O(n * width) memory.
+ * u and v (n each) receive the row and column potentials: every band
+ * cost is at least u[i] + v[j], so the result is optimal for the full
+ * problem too if that holds for the costs outside the bands.
+ * Returns the total cost, or INFEASIBLE if the bands admit no perfect
+ * assignment.
+ */
+double bandedAssignment(double *band, int *bandStart, int width, int n,
+                        int *rowAssign, double *u, double *v);
+
+#endif
@@ -0,0 +1,485 @@
+/* benchSuite.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * End-to-end benchmark behind `make bench`. For each collection size it
+ * generates a collection with genCollection, then measures:
+ *  - pagerank: collection load, getGraph and PageRankW, taken from the
+ *    phases of its --trace output.
+ *  - indexing: getInvertedList and writing the index (text plus term
+ *    dictionary), run in a child process linked against readData.
+ *  - queries: latency of single searchPagerank / searchTfIdf runs over a
+ *    fixed set of one to three word queries, as p50 / p99.
+ *  - scaledFootrule: merging three perturbed copies of the top pages.
+ *  - auction: the exact footrule assignment of those lists solved by the
+ *    auction on 1, 2, 4 ... threads up to the online CPUs, with the
+ *    speedup over one thread.
+ * Every measurement runs in its own process so its peak RSS is its own.
+ * Results go to stdout as one JSON object per line, e.g.
+ *  {"pages": 1000, "phase": "getGraph", "seconds": 0.03, "pagesPerSec": 33000, "maxRssKB": 5120}
+ *  {"pages": 1000, "query": "searchTfIdf", "queries": 50, "p50Ms": 4.1, "p99Ms": 6.3, ...}
+ *  {"pages": 1000, "phase": "auction", "urls": 500, "threads": 4, "seconds": 0.2, "speedup": 3.6}
+ *
+ * Usage: ./benchSuite [sizes ...] [--queries=N] [--agg=N] [--seed=N] [--dir=DIR]
+ * Run it from the directory holding the other binaries.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "readData.h"
+#include "BSTree.h"
+#include "termDict.h"
+#include "assignment.h"
+#include "footrule.h"
+#include "rng.h"
+
+#define TRUE            1
+#define FALSE           0
+#define MAX_SIZES       32
+#define MAX_PATH        4096
+#define MAX_QUERY_WORDS 3
+#define MAX_LINE        1001
+#define DEFAULT_SIZES   { 500, 1000, 2000 }
+#define N_DEFAULT_SIZES 3
+#define DEFAULT_QUERIES 50
+#define DEFAULT_AGG     500     // URLs in each scaledFootrule list
+#define DEFAULT_SEED    42
+#define DEFAULT_DIR     "benchData"
+#define N_RANK_LISTS    3
+#define SWAP_PERCENT    10      // adjacent swaps per list, % of its length
+#define AUCTION_EPS     1e-7    // scaledFootrule's default
+#define TRACE_FILE      "benchTrace.json"
+#define INDEX_FILE      "invertedIndex.txt"
+#define QUERIES_FLAG    "--queries="
+#define AGG_FLAG        "--agg="
+#define SEED_FLAG       "--seed="
+#define DIR_FLAG        "--dir="
+
+static unsigned long long rngState;
+static char binDir[MAX_PATH];   // where the benchmarked binaries are
+
+
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+
+static long peakRSS()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+
+// nearest rank percentile of n sorted values
+static double percentile(double *sorted, int n, double p)
+{
+    int rank = (int)(p * n + 0.999999);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+
+/* Runs binDir/args[0] with the other args, stdout to /dev/null unless
+ * output is given. Returns its wall time in seconds; peak RSS (KB) goes
+ * in maxRss. Exits if the program fails.
+ */
+static double runTool(char **args, char *output, long *maxRss)
+{
+    char path[2 * MAX_PATH];
+    snprintf(path, sizeof(path), "%s/%s", binDir, args[0]);
+    double start = now();
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork failed"); exit(EXIT_FAILURE); }
+    if (pid == 0) {
+        int fd = output != NULL ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+                                : open("/dev/null", O_WRONLY);
+        if (fd >= 0) { dup2(fd, STDOUT_FILENO); close(fd); }
+        execv(path, args);
+        perror("execv failed");
+        _exit(EXIT_FAILURE);
+    }
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    double seconds = now() - start;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "%s failed\n", args[0]);
+        exit(EXIT_FAILURE);
+    }
+    *maxRss = usage.ru_maxrss;
+    return seconds;
+}
+
+
+static void printPhase(int nPages, char *phase, double seconds, long maxRss)
+{
+    printf("{\"pages\": %d, \"phase\": \"%s\", \"seconds\": %.6f, "
+           "\"pagesPerSec\": %.0f, \"maxRssKB\": %ld}\n",
+           nPages, phase, seconds, seconds > 0 ? nPages / seconds : 0, maxRss);
+    fflush(stdout);
+}
+
+
+/* Reads the seconds of phase name from a pagerank --trace JSON file,
+ * -1 if it is not there.
+ */
+static double tracePhaseSeconds(char *traceText, char *name)
+{
+    char key[MAX_LINE];
+    snprintf(key, MAX_LINE, "\"%s\": ", name);
+    char *phases = strstr(traceText, "\"phases\"");
+    char *at = phases != NULL ? strstr(phases, key) : NULL;
+    return at != NULL ? atof(at + strlen(key)) : -1;
+}
+
+
+static char *readFile(char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    char *text = malloc(size + 1);
+    assert(text != NULL);
+    size = fread(text, 1, size, file);
+    text[size] = '\0';
+    fclose(file);
+    return text;
+}
+
+
+/* pagerank with a trace; its load, graph and iterate phases are
+ * getCollection, getGraph and PageRankW.
+ */
+static void benchPagerank(int nPages)
+{
+    char *args[] = { "pagerank", "0.85", "0.00001", "1000", "--trace=" TRACE_FILE, NULL };
+    long maxRss;
+    double seconds = runTool(args, NULL, &maxRss);
+    char *trace = readFile(TRACE_FILE);
+    printPhase(nPages, "getCollection", tracePhaseSeconds(trace, "load"), maxRss);
+    printPhase(nPages, "getGraph", tracePhaseSeconds(trace, "graph"), maxRss);
+    printPhase(nPages, "PageRankW", tracePhaseSeconds(trace, "iterate"), maxRss);
+    printPhase(nPages, "pagerank", seconds, maxRss);
+    free(trace);
+    remove(TRACE_FILE);
+}
+
+
+/* Builds the index in a child, timing getInvertedList and the writing of
+ * invertedIndex.txt and its dictionary separately.
+ */
+static void benchIndex(int nPages)
+{
+    int times[2];
+    if (pipe(times) != 0) { perror("pipe failed"); exit(EXIT_FAILURE); }
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork failed"); exit(EXIT_FAILURE); }
+    if (pid == 0) {
+        close(times[0]);
+        // no analysis, so the search tools must not find an old setting
+        clearAnalyser();
+        Set URLList = getCollection();
+        double result[4], start = now();
+        BSTree invList = getInvertedList(URLList, NULL, NULL);
+        result[0] = now() - start;
+        result[1] = peakRSS();
+        start = now();
+        FILE *index = fopen(INDEX_FILE, "w");
+        if (!index) { perror("fopen failed"); exit(EXIT_FAILURE); }
+        BSTreeInfix(index, invList);
+        fclose(index);
+        buildTermDict(INDEX_FILE, DICT_FILE);
+        result[2] = now() - start;
+        result[3] = peakRSS();
+        if (write(times[1], result, sizeof(result)) != sizeof(result)) _exit(EXIT_FAILURE);
+        _exit(0);
+    }
+    close(times[1]);
+    double result[4];
+    int ok = read(times[0], result, sizeof(result)) == sizeof(result);
+    close(times[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "indexing failed\n");
+        exit(EXIT_FAILURE);
+    }
+    printPhase(nPages, "getInvertedList", result[0], result[1]);
+    printPhase(nPages, "writeIndex", result[2], result[3]);
+}
+
+
+// the indexed words, from the first column of invertedIndex.txt
+static char **indexWords(int *nWords)
+{
+    char *text = readFile(INDEX_FILE);
+    int cap = 1024, n = 0;
+    char **words = malloc(cap * sizeof(char *));
+    assert(words != NULL);
+    char *line;
+    for (line = strtok(text, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+        char *end = strchr(line, ' ');
+        if (end == NULL || end == line) continue;
+        *end = '\0';
+        if (n == cap) {
+            cap *= 2;
+            words = realloc(words, cap * sizeof(char *));
+            assert(words != NULL);
+        }
+        words[n++] = strdup(line);
+    }
+    free(text);
+    *nWords = n;
+    return words;
+}
+
+
+/* Runs every query through tool and reports the latency percentiles,
+ * throughput and the largest peak RSS of any run.
+ */
+static void benchQueries(int nPages, char *tool, char ***queries, int nQueries)
+{
+    double *latency = malloc(nQueries * sizeof(double));
+    assert(latency != NULL);
+    double total = 0;
+    long maxRss = 0;
+    int q;
+    for (q = 0; q < nQueries; q++) {
+        char *args[MAX_QUERY_WORDS + 2] = { tool };
+        int k;
+        for (k = 0; queries[q][k] != NULL; k++) args[k + 1] = queries[q][k];
+        args[k + 1] = NULL;
+        long rss;
+        latency[q] = runTool(args, NULL, &rss);
+        total += latency[q];
+        if (rss > maxRss) maxRss = rss;
+    }
+    qsort(latency, nQueries, sizeof(double), compareDouble);
+    printf("{\"pages\": %d, \"query\": \"%s\", \"queries\": %d, \"p50Ms\": %.3f, "
+           "\"p99Ms\": %.3f, \"queriesPerSec\": %.1f, \"maxRssKB\": %ld}\n",
+           nPages, tool, nQueries, 1000 * percentile(latency, nQueries, 0.5),
+           1000 * percentile(latency, nQueries, 0.99),
+           total > 0 ? nQueries / total : 0, maxRss);
+    fflush(stdout);
+    free(latency);
+}
+
+
+/* Times the auction on the footrule costs of the n URLs at positions
+ * listPos[k][url] of N_RANK_LISTS lists, on 1, 2, 4 ... threads up to the
+ * online CPUs, in a child process so its RSS is its own.
+ */
+static void benchAuction(int nPages, int **listPos, int n)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork failed"); exit(EXIT_FAILURE); }
+    if (pid == 0) {
+        double *cost = malloc((long)n * n * sizeof(double));
+        double *slots = footruleSlots(n);
+        int *assign = malloc(n * sizeof(int));
+        assert(cost != NULL && assign != NULL);
+        int i, k;
+        for (i = 0; i < n; i++) {
+            double norm[N_RANK_LISTS];
+            for (k = 0; k < N_RANK_LISTS; k++) norm[k] = (listPos[k][i] + 1.0) / n;
+            footruleRow(cost + (long)i * n, norm, N_RANK_LISTS, slots, n);
+        }
+        int maxThreads = sysconf(_SC_NPROCESSORS_ONLN), threads;
+        if (maxThreads < 1) maxThreads = 1;
+        double single = 0;
+        for (threads = 1; threads <= maxThreads; threads *= 2) {
+            // the last step is all the CPUs even if that is not a power of two
+            if (threads * 2 > maxThreads) threads = maxThreads;
+            double start = now();
+            auction(cost, n, AUCTION_EPS, threads, assign);
+            double seconds = now() - start;
+            if (threads == 1) single = seconds;
+            printf("{\"pages\": %d, \"phase\": \"auction\", \"urls\": %d, \"threads\": %d, "
+                   "\"seconds\": %.6f, \"speedup\": %.2f, \"maxRssKB\": %ld}\n",
+                   nPages, n, threads, seconds, seconds > 0 ? single / seconds : 0, peakRSS());
+            fflush(stdout);
+        }
+        free(cost); free(slots); free(assign);
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "auction failed\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+/* Writes N_RANK_LISTS rank files holding the top aggURLs pages of
+ * pagerankList.txt, each with its own random adjacent swaps, and merges
+ * them with scaledFootrule; then times the auction on the same lists.
+ */
+static void benchAggregation(int nPages, int aggURLs)
+{
+    FILE *ranks = fopen("pagerankList.txt", "r");
+    if (!ranks) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    char **urls = malloc(aggURLs * sizeof(char *));
+    assert(urls != NULL);
+    char line[MAX_LINE];
+    int n = 0, i, k;
+    while (n < aggURLs && fgets(line, MAX_LINE, ranks) != NULL) {
+        char *comma = strchr(line, ',');
+        if (comma != NULL) *comma = '\0';
+        urls[n++] = strdup(line);
+    }
+    fclose(ranks);
+
+    char names[N_RANK_LISTS][MAX_LINE];
+    char *args[N_RANK_LISTS + 2] = { "scaledFootrule" };
+    int *order = malloc(n * sizeof(int));
+    int *listPos[N_RANK_LISTS];
+    assert(order != NULL);
+    for (k = 0; k < N_RANK_LISTS; k++) {
+        listPos[k] = malloc(n * sizeof(int));
+        assert(listPos[k] != NULL);
+        for (i = 0; i < n; i++) order[i] = i;
+        int swaps = n > 1 ? n * SWAP_PERCENT / 100 * (k + 1) : 0;
+        for (i = 0; i < swaps; i++) {
+            int at = nextRandom(&rngState) % (n - 1), tmp = order[at];
+            order[at] = order[at + 1];
+            order[at + 1] = tmp;
+        }
+        snprintf(names[k], MAX_LINE, "benchRank%d.txt", k);
+        FILE *file = fopen(names[k], "w");
+        if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+        for (i = 0; i < n; i++) {
+            fprintf(file, "%s\n", urls[order[i]]);
+            listPos[k][order[i]] = i;
+        }
+        fclose(file);
+        args[k + 1] = names[k];
+    }
+    args[N_RANK_LISTS + 1] = NULL;
+    long maxRss;
+    double seconds = runTool(args, NULL, &maxRss);
+    printf("{\"pages\": %d, \"phase\": \"scaledFootrule\", \"urls\": %d, \"lists\": %d, "
+           "\"seconds\": %.6f, \"maxRssKB\": %ld}\n",
+           nPages, n, N_RANK_LISTS, seconds, maxRss);
+    fflush(stdout);
+    for (k = 0; k < N_RANK_LISTS; k++) remove(names[k]);
+    if (n > 0) benchAuction(nPages, listPos, n);
+    for (k = 0; k < N_RANK_LISTS; k++) free(listPos[k]);
+    for (i = 0; i < n; i++) free(urls[i]);
+    free(urls); free(order);
+}
+
+
+static void benchSize(int nPages, char *dataDir, int nQueries, int aggURLs,
+                      unsigned long long seed)
+{
+    char dir[3 * MAX_PATH], pagesArg[MAX_LINE], dirArg[3 * MAX_PATH + 8], seedArg[MAX_LINE];
+    snprintf(dir, sizeof(dir), "%s/%d", dataDir, nPages);
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) { perror("mkdir failed"); exit(EXIT_FAILURE); }
+    snprintf(pagesArg, MAX_LINE, "%d", nPages);
+    snprintf(dirArg, sizeof(dirArg), "--dir=%s", dir);
+    snprintf(seedArg, MAX_LINE, "--seed=%llu", seed);
+    char *genArgs[] = { "genCollection", pagesArg, dirArg, seedArg, NULL };
+    long maxRss;
+    runTool(genArgs, NULL, &maxRss);
+    if (chdir(dir) != 0) { perror("chdir failed"); exit(EXIT_FAILURE); }
+
+    benchPagerank(nPages);
+    benchIndex(nPages);
+
+    // the same queries for both tools; an empty index has nothing to ask
+    int nWords, q, k;
+    char **words = indexWords(&nWords);
+    if (nWords > 0) {
+        char ***queries = malloc(nQueries * sizeof(char **));
+        assert(queries != NULL);
+        // the same seed, so every run asks the same queries
+        rngState = seedRandom(seed);
+        for (q = 0; q < nQueries; q++) {
+            int len = 1 + nextRandom(&rngState) % MAX_QUERY_WORDS;
+            queries[q] = malloc((len + 1) * sizeof(char *));
+            assert(queries[q] != NULL);
+            for (k = 0; k < len; k++) queries[q][k] = words[nextRandom(&rngState) % nWords];
+            queries[q][len] = NULL;
+        }
+        benchQueries(nPages, "searchPagerank", queries, nQueries);
+        benchQueries(nPages, "searchTfIdf", queries, nQueries);
+        for (q = 0; q < nQueries; q++) free(queries[q]);
+        free(queries);
+    }
+    benchAggregation(nPages, aggURLs);
+
+    for (k = 0; k < nWords; k++) free(words[k]);
+    free(words);
+    if (chdir(binDir) != 0) { perror("chdir failed"); exit(EXIT_FAILURE); }
+}
+
+
+int main(int argc, char **argv)
+{
+    int sizes[MAX_SIZES], nSizes = 0;
+    int nQueries = DEFAULT_QUERIES, aggURLs = DEFAULT_AGG;
+    unsigned long long seed = DEFAULT_SEED;
+    char *dataDir = DEFAULT_DIR;
+    int i;
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], QUERIES_FLAG, strlen(QUERIES_FLAG)) == 0) {
+            nQueries = atoi(argv[i] + strlen(QUERIES_FLAG));
+        } else if (strncmp(argv[i], AGG_FLAG, strlen(AGG_FLAG)) == 0) {
+            aggURLs = atoi(argv[i] + strlen(AGG_FLAG));
+        } else if (strncmp(argv[i], SEED_FLAG, strlen(SEED_FLAG)) == 0) {
+            seed = strtoull(argv[i] + strlen(SEED_FLAG), NULL, 10);
+        } else if (strncmp(argv[i], DIR_FLAG, strlen(DIR_FLAG)) == 0) {
+            dataDir = argv[i] + strlen(DIR_FLAG);
+        } else if (atoi(argv[i]) > 0 && nSizes < MAX_SIZES) {
+            sizes[nSizes++] = atoi(argv[i]);
+        } else {
+            printf("Usage: ./benchSuite [sizes ...] [%sN] [%sN] [%sN] [%sDIR]\n",
+                   QUERIES_FLAG, AGG_FLAG, SEED_FLAG, DIR_FLAG);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (nSizes == 0) {
+        int defaults[] = DEFAULT_SIZES;
+        for (; nSizes < N_DEFAULT_SIZES; nSizes++) sizes[nSizes] = defaults[nSizes];
+    }
+    if (nQueries < 1) nQueries = 1;
+    if (aggURLs < 1) aggURLs = 1;
+    if (getcwd(binDir, MAX_PATH) == NULL) { perror("getcwd failed"); exit(EXIT_FAILURE); }
+    if (mkdir(dataDir, 0755) != 0 && errno != EEXIST) { perror("mkdir failed"); exit(EXIT_FAILURE); }
+    // collections are made relative to binDir, benchSize changes into them
+    char absData[2 * MAX_PATH + 1];
+    if (dataDir[0] == '/') snprintf(absData, sizeof(absData), "%s", dataDir);
+    else snprintf(absData, sizeof(absData), "%s/%s", binDir, dataDir);
+
+    for (i = 0; i < nSizes; i++) benchSize(sizes[i], absData, nQueries, aggURLs, seed);
+    return 0;
+}
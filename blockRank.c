@@ -0,0 +1,281 @@
+/* blockRank.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * WHY IT WORKS:
+ * PR(v) = (1-d)/N + d * sum PR(u) * W(u,v) over the in-links of v.
+ * If u is in an upstream component its rank is already final, so for a
+ * component C the equation splits into a constant part (links from
+ * upstream) and a small system over C's own links. Chains of components
+ * are then solved once each instead of being swept every iteration, and
+ * singleton components need exactly one pass.
+ * The result is the fixed point of the whole system to within diffPR,
+ * the same as power iteration run to convergence, and not the default
+ * mode's sweep, which stops on the change of the last URL alone.
+ *
+ * PSEUDOCODE:
+ * comps = tarjan(g)             // reverse topological order
+ * level(C) = 1 + max level(upstream of C), 0 for sources
+ * for each level:
+ *     for each C in level (in parallel):
+ *         base(v) = (1-d)/N + d * sum over upstream in-links
+ *         iterate x(v) = base(v) + d * sum over in-links inside C
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <pthread.h>
+#include "linkGraph.h"
+#include "prTrace.h"
+#include "blockRank.h"
+
+#define UNVISITED   -1
+#define MAX_THREADS 256
+
+typedef struct blockState {
+    LinkGraph g;
+    double    damp;
+    double    diffPR;
+    int       maxIterations;
+    int      *comp;          // component of each URL, topological numbering
+    int      *members;       // URLs grouped by component
+    int      *memberStart;   // members of c are members[memberStart[c] ..]
+    int      *levelComps;    // components grouped by level
+    double   *ranks;
+    double   *scratch;
+    int       next;          // next index in levelComps to hand out
+    int       levelEnd;
+    long      edges;         // in-links scanned in the current level
+    double    residual;
+    pthread_mutex_t lock;
+} BlockState;
+
+
+/* Tarjan's algorithm without recursion. Returns the number of
+ * components; comp[v] is numbered so that links only go from lower to
+ * higher component numbers (topological order).
+ */
+static int tarjan(LinkGraph g, int *comp)
+{
+    int n = g->nURLs;
+    int *outDst; long *edgeOf;
+    long *outStart = linkGraphOutLists(g, &outDst, &edgeOf);
+    free(edgeOf);
+    int *index = malloc(n * sizeof(int));
+    int *low = malloc(n * sizeof(int));
+    int *stack = malloc(n * sizeof(int));
+    int *callStack = malloc(n * sizeof(int));
+    long *nextEdge = malloc(n * sizeof(long));
+    char *onStack = calloc(n, sizeof(char));
+    assert(index != NULL && low != NULL && stack != NULL && callStack != NULL);
+    assert(nextEdge != NULL && onStack != NULL);
+    int v;
+    for (v = 0; v < n; v++) index[v] = UNVISITED;
+
+    int counter = 0, top = 0, nComps = 0, root;
+    for (root = 0; root < n; root++) {
+        if (index[root] != UNVISITED) continue;
+        int depth = 0;
+        callStack[depth++] = root;
+        index[root] = low[root] = counter++;
+        nextEdge[root] = outStart[root];
+        stack[top++] = root; onStack[root] = 1;
+        while (depth > 0) {
+            v = callStack[depth - 1];
+            if (nextEdge[v] < outStart[v + 1]) {
+                int w = outDst[nextEdge[v]++];
+                if (index[w] == UNVISITED) {
+                    index[w] = low[w] = counter++;
+                    nextEdge[w] = outStart[w];
+                    stack[top++] = w; onStack[w] = 1;
+                    callStack[depth++] = w;
+                } else if (onStack[w] && index[w] < low[v]) {
+                    low[v] = index[w];
+                }
+                continue;
+            }
+            // all links of v explored
+            depth--;
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = stack[--top];
+                    onStack[w] = 0;
+                    comp[w] = nComps;
+                } while (w != v);
+                nComps++;
+            }
+            if (depth > 0) {
+                int parent = callStack[depth - 1];
+                if (low[v] < low[parent]) low[parent] = low[v];
+            }
+        }
+    }
+    // Tarjan finishes sinks first, so flip the numbering.
+    for (v = 0; v < n; v++) comp[v] = nComps - 1 - comp[v];
+    free(outStart); free(outDst); free(index); free(low); free(stack);
+    free(callStack); free(nextEdge); free(onStack);
+    return nComps;
+}
+
+
+/* Solves one component given final ranks for everything upstream. */
+static void solveComponent(BlockState *s, int c, long *edges, double *residual)
+{
+    LinkGraph g = s->g;
+    int n = g->nURLs;
+    int *nodes = s->members + s->memberStart[c];
+    int size = s->memberStart[c + 1] - s->memberStart[c];
+    int i, iter;
+    long e, scanned = 0, internal = 0;
+    double *base = s->scratch;  // base[v] then reused for the next x[v]
+    double *next = malloc(size * sizeof(double));
+    assert(next != NULL);
+
+    for (i = 0; i < size; i++) {
+        int v = nodes[i];
+        double sum = 0;
+        for (e = g->inStart[v]; e < g->inStart[v + 1]; e++) {
+            int u = g->inSrc[e];
+            if (s->comp[u] != c) sum += s->ranks[u] * g->inWeight[e];
+            else internal++;
+        }
+        scanned += g->inStart[v + 1] - g->inStart[v];
+        base[v] = (1 - s->damp)/n + s->damp * sum;
+    }
+    double diff = 0;
+    if (internal == 0) {
+        for (i = 0; i < size; i++) s->ranks[nodes[i]] = base[nodes[i]];
+    } else {
+        // share of the global tolerance proportional to the component size
+        double tol = s->diffPR * size / n;
+        diff = tol;
+        for (iter = 0; iter < s->maxIterations && diff >= tol; iter++) {
+            for (i = 0; i < size; i++) {
+                int v = nodes[i];
+                double sum = 0;
+                for (e = g->inStart[v]; e < g->inStart[v + 1]; e++) {
+                    int u = g->inSrc[e];
+                    if (s->comp[u] == c) sum += s->ranks[u] * g->inWeight[e];
+                }
+                next[i] = base[v] + s->damp * sum;
+            }
+            diff = 0;
+            for (i = 0; i < size; i++) {
+                diff += fabs(next[i] - s->ranks[nodes[i]]);
+                s->ranks[nodes[i]] = next[i];
+            }
+            scanned += internal;
+        }
+    }
+    free(next);
+    *edges = scanned;
+    *residual = diff;
+}
+
+
+// worker: takes components of the current level until none are left
+static void *levelWorker(void *arg)
+{
+    BlockState *s = arg;
+    while (1) {
+        pthread_mutex_lock(&s->lock);
+        int k = s->next < s->levelEnd ? s->next++ : UNVISITED;
+        pthread_mutex_unlock(&s->lock);
+        if (k == UNVISITED) break;
+        long edges; double residual;
+        solveComponent(s, s->levelComps[k], &edges, &residual);
+        pthread_mutex_lock(&s->lock);
+        s->edges += edges;
+        s->residual += residual;
+        pthread_mutex_unlock(&s->lock);
+    }
+    return NULL;
+}
+
+
+// groups items 0..n-1 by key (0..nKeys-1); returns start offsets
+static int *groupBy(int *key, int n, int nKeys, int *grouped)
+{
+    int *start = calloc(nKeys + 1, sizeof(int));
+    int *next = malloc((nKeys + 1) * sizeof(int));
+    assert(start != NULL && next != NULL);
+    int i;
+    for (i = 0; i < n; i++) start[key[i] + 1]++;
+    for (i = 0; i < nKeys; i++) start[i + 1] += start[i];
+    memcpy(next, start, (nKeys + 1) * sizeof(int));
+    for (i = 0; i < n; i++) grouped[next[key[i]]++] = i;
+    free(next);
+    return start;
+}
+
+
+int blockPageRank(LinkGraph g, double damp, double diffPR, int maxIterations,
+                  int nThreads, double *ranks, PRTrace trace)
+{
+    int n = g->nURLs;
+    if (nThreads < 1) nThreads = 1;
+    if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+    BlockState s;
+    memset(&s, 0, sizeof(s));
+    s.g = g; s.damp = damp; s.diffPR = diffPR; s.maxIterations = maxIterations;
+    s.ranks = ranks;
+    s.comp = malloc((n + 1) * sizeof(int));
+    s.members = malloc((n + 1) * sizeof(int));
+    s.scratch = malloc((n + 1) * sizeof(double));
+    assert(s.comp != NULL && s.members != NULL && s.scratch != NULL);
+    pthread_mutex_init(&s.lock, NULL);
+    int v, c;
+    long e;
+    for (v = 0; v < n; v++) ranks[v] = 1.0/n;
+
+    int nComps = tarjan(g, s.comp);
+    s.memberStart = groupBy(s.comp, n, nComps, s.members);
+
+    // level of a component: longest chain of components feeding it
+    int *level = calloc(nComps + 1, sizeof(int));
+    assert(level != NULL);
+    int nLevels = 0;
+    for (c = 0; c < nComps; c++) {
+        int k;
+        for (k = s.memberStart[c]; k < s.memberStart[c + 1]; k++) {
+            v = s.members[k];
+            for (e = g->inStart[v]; e < g->inStart[v + 1]; e++) {
+                int from = s.comp[g->inSrc[e]];
+                if (from != c && level[from] + 1 > level[c]) level[c] = level[from] + 1;
+            }
+        }
+        if (level[c] + 1 > nLevels) nLevels = level[c] + 1;
+    }
+    s.levelComps = malloc((nComps + 1) * sizeof(int));
+    assert(s.levelComps != NULL);
+    int *levelStart = groupBy(level, nComps, nLevels, s.levelComps);
+
+    pthread_t threads[MAX_THREADS];
+    int l, t;
+    traceStartIterations(trace);
+    for (l = 0; l < nLevels; l++) {
+        s.next = levelStart[l];
+        s.levelEnd = levelStart[l + 1];
+        s.edges = 0; s.residual = 0;
+        int workers = s.levelEnd - s.next;
+        if (workers > nThreads) workers = nThreads;
+        // small levels are not worth a thread
+        if (workers <= 1) {
+            levelWorker(&s);
+        } else {
+            for (t = 0; t < workers; t++) pthread_create(&threads[t], NULL, levelWorker, &s);
+            for (t = 0; t < workers; t++) pthread_join(threads[t], NULL);
+        }
+        traceIteration(trace, s.residual, s.edges);
+    }
+    pthread_mutex_destroy(&s.lock);
+    free(level); free(levelStart); free(s.levelComps); free(s.memberStart);
+    free(s.comp); free(s.members); free(s.scratch);
+    return nComps;
+}
@@ -0,0 +1,27 @@
+/* blockRank.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * PageRank solved one strongly connected component at a time, in
+ * topological order of the component graph.
+ */
+
+#include "linkGraph.h"
+#include "prTrace.h"
+
+#ifndef BLOCKRANK_H
+#define BLOCKRANK_H
+
+/* Weighted PageRank over g, solving each SCC once its upstream
+ * components have converged. Components with no path between them
+ * are solved on up to nThreads threads. One trace record is written
+ * per level of the component graph. Returns the number of SCCs.
+ * The reference is the PageRank fixed point (linkGraphPageRank run to
+ * convergence): each component stops within its share of diffPR of it.
+ * It is not linkGraphSweepPageRank's early stop on the last URL.
+ */
+int blockPageRank(LinkGraph g, double damp, double diffPR, int maxIterations,
+                  int nThreads, double *ranks, PRTrace trace);
+
+#endif
@@ -0,0 +1,111 @@
+/* buildSearch.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Does the work of pagerank and invertedIndex together, reading every
+ * page once: the links and the words of each page are taken from the
+ * same read (see libsearch.h), instead of invertedIndex reading all the
+ * pages and then getGraph reading them all again.
+ *
+ * OUTPUT: pagerankList.txt and invertedIndex.txt exactly as the two
+ * tools write them (pagerank in its default mode), plus the
+ * pagerankList.bin, invertedIndex.dict and analysis.txt they leave.
+ *
+ * Usage: ./buildSearch damping diffPR maxIterations [--stem] [--stop[=FILE]]
+ *        [--stats]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libsearch.h"
+#include "analyser.h"
+#include "termDict.h"
+#include "rankTable.h"
+#include "stats.h"
+
+#define TRUE            1
+#define FALSE           0
+#define REQUIRED_ARGS   4
+#define DAMPING         1
+#define DIFFPR          2
+#define MAX_ITER        3
+#define STEM_FLAG       "--stem"
+#define STOP_FLAG       "--stop"
+#define INDEX_FILE      "invertedIndex.txt"
+#define PAGERANK_FILE   "pagerankList.txt"
+
+
+static FILE *openOrDie(char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    return file;
+}
+
+
+int main(int argc, char **argv)
+{
+    statsInit(&argc, argv);
+    if (argc < REQUIRED_ARGS) {
+        printf("Usage: ./buildSearch damping diffPR maxIterations "
+               "[%s] [%s[=FILE]] [%s]\n", STEM_FLAG, STOP_FLAG, STATS_FLAG);
+        exit(EXIT_FAILURE);
+    }
+    double damp = atof(argv[DAMPING]);
+    double diffPR = atof(argv[DIFFPR]);
+    int maxIterations = atoi(argv[MAX_ITER]);
+    int stem = FALSE, i;
+    char *stopFile = NULL;
+    for (i = REQUIRED_ARGS; i < argc; i++) {
+        if (strncmp(argv[i], STEM_FLAG, strlen(STEM_FLAG)) == 0) {
+            stem = TRUE;
+        } else if (strncmp(argv[i], STOP_FLAG, strlen(STOP_FLAG)) == 0) {
+            char *file = strchr(argv[i], '=');
+            stopFile = file != NULL ? file + 1 : DEFAULT_STOP;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    // the search tools pick the analysis up from ANALYSIS_FILE
+    if (stem || stopFile != NULL) {
+        Analyser analyser = newAnalyser(stem, stopFile);
+        saveAnalyser(analyser);
+        freeAnalyser(analyser);
+    } else {
+        clearAnalyser();
+    }
+
+    double start = statsClock();
+    SearchCollection c = openCollection(".");
+    if (c == NULL) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    statsTime("load", start);
+    // one pass over the pages: the words go into the index and the
+    // links are kept in the collection for the ranker
+    start = statsClock();
+    SearchIndex index = buildIndex(c, stem, stopFile);
+    statsTime("parse", start);
+    start = statsClock();
+    SearchRanker ranker = buildRanker(c, damp, diffPR, maxIterations);
+    statsTime("rank", start);
+
+    start = statsClock();
+    FILE *file = openOrDie(INDEX_FILE);
+    writeIndex(index, file);
+    fclose(file);
+    file = openOrDie(PAGERANK_FILE);
+    writeRanks(ranker, file);
+    fclose(file);
+    writeRankerTable(ranker, RANK_TABLE, PAGERANK_FILE);
+    statsTime("write", start);
+    start = statsClock();
+    buildTermDict(INDEX_FILE, DICT_FILE);
+    statsTime("dictionary", start);
+
+    freeIndex(index);
+    freeRanker(ranker);
+    closeCollection(c);
+    return 0;
+}
@@ -0,0 +1,235 @@
+/* checkSolvers.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Regression check for the assignment solvers behind scaledFootrule:
+ * hungarian, auction and bandedAssignment are run on random instances
+ * with n <= MAX_N and compared with the optimum found by trying every
+ * permutation. auction may be up to n * eps above it; banded is checked
+ * both with the full band and with a narrower one, against the best
+ * permutation that stays inside the bands.
+ * The threaded bidding of auction only starts on larger matrices, so a
+ * few LARGE_N instances compare it on up to MAX_THREADS threads with one
+ * thread (identical) and with hungarian (within n * eps).
+ * auction must refuse an eps that is not greater than 0.
+ *
+ * OUTPUT: the first mismatch, or the number of instances checked.
+ * Exits with failure on a mismatch.
+ *
+ * Usage: ./checkSolvers [--seed=N] [--instances=N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "assignment.h"
+#include "rng.h"
+
+#define TRUE            1
+#define FALSE           0
+#define MAX_N           8
+#define DEFAULT_SEED    1
+#define DEFAULT_COUNT   2000
+#define EPS             1e-6
+#define TOLERANCE       1e-9
+#define MAX_THREADS     3
+#define LARGE_N         300
+#define LARGE_COUNT     4
+#define SEED_FLAG       "--seed="
+#define COUNT_FLAG      "--instances="
+
+static unsigned long long rngState;
+
+
+/* Cheapest permutation of the n x n costs by trying them all, keeping
+ * only those with start[i] <= perm[i] < start[i] + width for every row.
+ * Returns INFEASIBLE if none does.
+ */
+static double bruteForce(double *cost, int n, int *start, int width)
+{
+    int perm[MAX_N], i;
+    for (i = 0; i < n; i++) perm[i] = i;
+    double best = INFEASIBLE;
+    while (TRUE) {
+        double total = 0;
+        int inside = TRUE;
+        for (i = 0; i < n && inside; i++) {
+            inside = perm[i] >= start[i] && perm[i] < start[i] + width;
+            total += cost[i * n + perm[i]];
+        }
+        if (inside && (best == INFEASIBLE || total < best)) best = total;
+
+        // next permutation in lexicographic order
+        int k = n - 2, l = n - 1;
+        while (k >= 0 && perm[k] >= perm[k + 1]) k--;
+        if (k < 0) break;
+        while (perm[l] <= perm[k]) l--;
+        int t = perm[k]; perm[k] = perm[l]; perm[l] = t;
+        for (i = k + 1, l = n - 1; i < l; i++, l--) {
+            t = perm[i]; perm[i] = perm[l]; perm[l] = t;
+        }
+    }
+    return best;
+}
+
+
+/* Checks that assign is a permutation inside the bands whose cost is
+ * total, and that total is within slack above opt.
+ */
+static int checkResult(char *solver, double *cost, int n, int *start, int width,
+                       int *assign, double total, double opt, double slack)
+{
+    char *used = calloc(n, sizeof(char));
+    assert(used != NULL);
+    double sum = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        int j = assign[i];
+        if (j < start[i] || j >= start[i] + width || j >= n || used[j]) {
+            printf("%s: row %d given column %d\n", solver, i, j);
+            free(used);
+            return FALSE;
+        }
+        used[j] = TRUE;
+        sum += cost[i * n + j];
+    }
+    free(used);
+    if (fabs(sum - total) > TOLERANCE || total > opt + slack + TOLERANCE
+        || total < opt - TOLERANCE) {
+        printf("%s: total %.12f (assignment %.12f), optimum %.12f\n",
+               solver, total, sum, opt);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+
+/* bandedAssignment of cost restricted to rows' bands of the given width,
+ * checked against the brute force over the same bands.
+ */
+static int checkBanded(double *cost, int n, int width)
+{
+    int start[MAX_N], assign[MAX_N], i, j;
+    double band[MAX_N * MAX_N], u[MAX_N], v[MAX_N];
+    for (i = 0; i < n; i++) {
+        start[i] = i - width / 2;
+        if (start[i] > n - width) start[i] = n - width;
+        if (start[i] < 0) start[i] = 0;
+        for (j = 0; j < width; j++) band[i * width + j] = cost[i * n + start[i] + j];
+    }
+    double opt = bruteForce(cost, n, start, width);
+    double total = bandedAssignment(band, start, width, n, assign, u, v);
+    if (opt == INFEASIBLE || total == INFEASIBLE) {
+        if (opt == total) return TRUE;
+        printf("banded width %d: total %f, optimum %f\n", width, total, opt);
+        return FALSE;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "banded width %d", width);
+    return checkResult(name, cost, n, start, width, assign, total, opt, 0);
+}
+
+
+// one random instance; FALSE on the first solver that gets it wrong
+static int checkInstance(int n)
+{
+    double cost[MAX_N * MAX_N];
+    int start[MAX_N] = { 0 }, assign[MAX_N], i;
+    // half the instances have small integer costs, so optima tie
+    int ties = nextRandom(&rngState) % 2;
+    for (i = 0; i < n * n; i++) {
+        cost[i] = ties ? (double)(nextRandom(&rngState) % 4) : uniform(&rngState);
+    }
+    double opt = bruteForce(cost, n, start, n);
+
+    double total = hungarian(cost, n, n, assign);
+    if (!checkResult("hungarian", cost, n, start, n, assign, total, opt, 0)) return FALSE;
+
+    int threads = 1 + nextRandom(&rngState) % MAX_THREADS;
+    total = auction(cost, n, EPS, threads, assign);
+    if (!checkResult("auction", cost, n, start, n, assign, total, opt, n * EPS)) return FALSE;
+
+    if (!checkBanded(cost, n, n)) return FALSE;
+    return checkBanded(cost, n, 1 + nextRandom(&rngState) % n);
+}
+
+
+/* auction on nThreads threads against one thread and hungarian on a
+ * LARGE_N instance.
+ */
+static int checkLarge(int nThreads)
+{
+    int n = LARGE_N, i;
+    double *cost = malloc(n * n * sizeof(double));
+    int *assign = malloc(n * sizeof(int)), *serial = malloc(n * sizeof(int));
+    int *start = calloc(n, sizeof(int));
+    assert(cost != NULL && assign != NULL && serial != NULL && start != NULL);
+    for (i = 0; i < n * n; i++) cost[i] = uniform(&rngState);
+
+    double opt = hungarian(cost, n, n, assign);
+    double one = auction(cost, n, EPS, 1, serial);
+    double total = auction(cost, n, EPS, nThreads, assign);
+    int ok = checkResult("auction", cost, n, start, n, assign, total, opt, n * EPS);
+    if (ok && (total != one || memcmp(assign, serial, n * sizeof(int)) != 0)) {
+        printf("auction: %d threads total %.12f, one thread %.12f\n", nThreads, total, one);
+        ok = FALSE;
+    }
+    free(cost); free(assign); free(serial); free(start);
+    return ok;
+}
+
+
+// eps <= 0 (or NaN) would never end the eps scaling
+static int checkBadEps()
+{
+    double cost[4] = { 1, 2, 2, 1 }, bad[3] = { 0, -1, NAN };
+    int assign[2], k;
+    for (k = 0; k < 3; k++) {
+        if (auction(cost, 2, bad[k], 1, assign) != INFEASIBLE) {
+            printf("auction: eps %f accepted\n", bad[k]);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+int main(int argc, char **argv)
+{
+    unsigned long long seed = DEFAULT_SEED;
+    int count = DEFAULT_COUNT, i;
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], SEED_FLAG, strlen(SEED_FLAG)) == 0) {
+            seed = strtoull(argv[i] + strlen(SEED_FLAG), NULL, 10);
+        } else if (strncmp(argv[i], COUNT_FLAG, strlen(COUNT_FLAG)) == 0) {
+            count = atoi(argv[i] + strlen(COUNT_FLAG));
+        } else {
+            printf("Usage: ./checkSolvers [--seed=N] [--instances=N]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    rngState = seedRandom(seed);
+
+    for (i = 0; i < count; i++) {
+        int n = 1 + nextRandom(&rngState) % MAX_N;
+        if (!checkInstance(n)) {
+            printf("checkSolvers: instance %d (n = %d, seed %llu) failed\n", i, n, seed);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!checkBadEps()) {
+        printf("checkSolvers: eps check failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < LARGE_COUNT; i++) {
+        if (!checkLarge(2 + i % (MAX_THREADS - 1))) {
+            printf("checkSolvers: large instance %d (seed %llu) failed\n", i, seed);
+            exit(EXIT_FAILURE);
+        }
+    }
+    printf("checkSolvers: %d instances OK\n", count + LARGE_COUNT);
+    return 0;
+}
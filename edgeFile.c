@@ -0,0 +1,411 @@
+/* edgeFile.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * BUILDING THE FILE:
+ * 1. Read each page's outlinks and append (src, dst) pairs to a raw file.
+ *    Only the in/out degree counters are kept in memory.
+ * 2. Scan the raw file (grouped by src) to compute Win * Wout for every
+ *    edge and scatter the records into bucket files by destination range.
+ *    Each bucket holds at most memMB worth of records, so there are about
+ *    nEdges / maxEdges of them; when that is more files than can be open
+ *    at once the raw file is scanned once per group of buckets.
+ * 3. Load one bucket at a time, counting sort it by destination and
+ *    append it to the final edge file. A bucket that is bigger than memMB
+ *    has a single destination and is copied across without loading it.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <unistd.h>
+#include "set.h"
+#include "readData.h"
+#include "hashMap.h"
+#include "edgeFile.h"
+#include "fileUtil.h"
+
+#define URL_LENGTH      55
+#define OPEN_RESERVE    16      // descriptors left for everything else
+#define READ_BATCH      4096
+#define NO_OUTLINKS     0.5
+#define NAME_SPACE      16
+#define MB              (1024 * 1024)
+
+typedef struct rawEdge {
+    int src;
+    int dst;
+} RawEdge;
+
+
+// opens a file or exits like the rest of the tools
+static FILE *openOrDie(char *fileName, char *mode)
+{
+    FILE *file = fopen(fileName, mode);
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    return file;
+}
+
+
+// a short write means the disk is full, and the file cannot be used
+static void writeOrDie(void *ptr, size_t size, size_t n, FILE *file)
+{
+    if (fwrite(ptr, size, n, file) != n) { perror("fwrite failed"); exit(EXIT_FAILURE); }
+}
+
+
+// closes a file that was written, exiting if any write to it failed
+static void closeOrDie(FILE *file)
+{
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) { perror("fclose failed"); exit(EXIT_FAILURE); }
+}
+
+
+/* Step 1: writes raw (src, dst) pairs and counts degrees. */
+static long writeRawEdges(Set URLList, HashMap ids, FILE *raw, int *outDegree, int *inDegree)
+{
+    int nURLs = nElems(URLList);
+    // lastSeen[dst] == src means the link was already added for this page
+    int *lastSeen = malloc(nURLs * sizeof(int));
+    assert(lastSeen != NULL);
+    int i, j;
+    for (i = 0; i < nURLs; i++) lastSeen[i] = NOT_FOUND;
+
+    long nEdges = 0;
+    char fileName[URL_LENGTH] = {0};
+    SetNode curr = URLList->elems;
+    for (i = 0; curr != NULL; curr = curr->next, i++) {
+        sprintf(fileName, "%s.txt", curr->val);
+        int url_size; int text_size;
+        spaceRequired(fileName, &url_size, &text_size);
+        char *urls = calloc(url_size + 1, sizeof(char));
+        char *text = calloc(text_size + 1, sizeof(char));
+        readPage(urls, text, fileName);
+        trim(urls);
+        if (strlen(urls) != 0) {
+            char **outLinks = tokenise(urls, " ");
+            for (j = 0; outLinks[j] != NULL; j++) {
+                int dst = hashMapGet(ids, outLinks[j]);
+                // no links outside the collection, no loops, no parallel edges
+                if (dst == NOT_FOUND || dst == i || lastSeen[dst] == i) continue;
+                lastSeen[dst] = i;
+                RawEdge e = { i, dst };
+                writeOrDie(&e, sizeof(RawEdge), 1, raw);
+                outDegree[i]++; inDegree[dst]++;
+                nEdges++;
+            }
+            freeTokens(outLinks);
+        }
+        free(urls); free(text);
+    }
+    free(lastSeen);
+    return nEdges;
+}
+
+
+/* Splits the destination IDs into contiguous ranges of at most
+ * maxEdges in-links each (or a single destination with more). bucketSize
+ * has room for nURLs buckets. Returns the number of buckets used.
+ */
+static int assignBuckets(int *inDegree, int nURLs, long maxEdges, int *bucketOf, long *bucketSize)
+{
+    int b = 0, i;
+    long inBucket = 0;
+    for (i = 0; i < nURLs; i++) {
+        if (inBucket > 0 && inBucket + inDegree[i] > maxEdges) {
+            bucketSize[b++] = inBucket;
+            inBucket = 0;
+        }
+        bucketOf[i] = b;
+        inBucket += inDegree[i];
+    }
+    bucketSize[b] = inBucket;
+    return b + 1;
+}
+
+
+// name of the nth bucket file for the edge file fileName
+static void bucketName(char *buf, char *fileName, int b)
+{
+    sprintf(buf, "%s.%d", fileName, b);
+}
+
+
+/* Buckets that can be open at the same time: what the descriptor limit
+ * allows, and no more stdio buffers than fit in memMB.
+ */
+static int maxOpenBuckets(int memMB)
+{
+    long limit = sysconf(_SC_OPEN_MAX) - OPEN_RESERVE;
+    long buffers = (long)memMB * MB / BUFSIZ;
+    if (limit < 0 || buffers < limit) limit = buffers;
+    return limit < 1 ? 1 : limit > INT_MAX ? INT_MAX : limit;
+}
+
+
+/* Computes Win * Wout for all outlinks of one page and scatters the ones
+ * going to buckets first .. first + nOpen - 1.
+ */
+static void weighGroup(RawEdge *group, int n, int *outDegree, int *inDegree,
+                       int *bucketOf, FILE **buckets, int first, int nOpen)
+{
+    double inSum = 0, outSum = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        int dst = group[i].dst;
+        inSum += inDegree[dst];
+        outSum += outDegree[dst] == 0 ? NO_OUTLINKS : outDegree[dst];
+    }
+    for (i = 0; i < n; i++) {
+        int dst = group[i].dst;
+        if (bucketOf[dst] < first || bucketOf[dst] >= first + nOpen) continue;
+        double out = outDegree[dst] == 0 ? NO_OUTLINKS : outDegree[dst];
+        EdgeRecord e = { group[i].src, dst, (inDegree[dst] / inSum) * (out / outSum) };
+        writeOrDie(&e, sizeof(EdgeRecord), 1, buckets[bucketOf[dst] - first]);
+    }
+}
+
+
+/* Step 2: reads raw edges grouped by src and writes weighted bucket
+ * files, maxOpen of them per pass over the raw file.
+ */
+static void writeBuckets(FILE *raw, char *fileName, int nBuckets, int maxOpen,
+                         int *outDegree, int *inDegree, int *bucketOf)
+{
+    char name[URL_LENGTH + NAME_SPACE];
+    int nOpen = nBuckets < maxOpen ? nBuckets : maxOpen;
+    FILE **buckets = malloc(nOpen * sizeof(FILE *));
+    int cap = READ_BATCH;
+    RawEdge *group = malloc(cap * sizeof(RawEdge));
+    assert(buckets != NULL && group != NULL);
+    int first, b;
+    for (first = 0; first < nBuckets; first += nOpen) {
+        if (first + nOpen > nBuckets) nOpen = nBuckets - first;
+        for (b = 0; b < nOpen; b++) {
+            bucketName(name, fileName, first + b);
+            buckets[b] = openOrDie(name, "wb");
+        }
+        int n = 0;
+        RawEdge e;
+        rewind(raw);
+        while (fread(&e, sizeof(RawEdge), 1, raw) == 1) {
+            if (n > 0 && group[0].src != e.src) {
+                weighGroup(group, n, outDegree, inDegree, bucketOf, buckets, first, nOpen);
+                n = 0;
+            }
+            if (n == cap) {
+                cap *= 2;
+                group = realloc(group, cap * sizeof(RawEdge));
+                assert(group != NULL);
+            }
+            group[n++] = e;
+        }
+        if (n > 0) weighGroup(group, n, outDegree, inDegree, bucketOf, buckets, first, nOpen);
+        for (b = 0; b < nOpen; b++) closeOrDie(buckets[b]);
+    }
+    free(group); free(buckets);
+}
+
+
+/* Appends the n records of bucket to out in batches; for a bucket with
+ * one destination, which is already in order.
+ */
+static void copyBucket(FILE *bucket, char *name, long n, FILE *out)
+{
+    EdgeRecord *batch = malloc(READ_BATCH * sizeof(EdgeRecord));
+    assert(batch != NULL);
+    while (n > 0) {
+        size_t want = n < READ_BATCH ? n : READ_BATCH;
+        if (fread(batch, sizeof(EdgeRecord), want, bucket) != want) {
+            fprintf(stderr, "%s: short read\n", name);
+            exit(EXIT_FAILURE);
+        }
+        writeOrDie(batch, sizeof(EdgeRecord), want, out);
+        n -= want;
+    }
+    free(batch);
+}
+
+
+/* Step 3: sorts each bucket by dst in memory and appends it to out. */
+static void mergeBuckets(FILE *out, char *fileName, int nBuckets, long *bucketSize,
+                         int *inDegree, int *bucketOf, int nURLs)
+{
+    char name[URL_LENGTH + NAME_SPACE];
+    // offset[dst] is where dst's next in-link goes within its bucket
+    long *offset = malloc(nURLs * sizeof(long));
+    assert(offset != NULL);
+    int b, dst = 0;
+    for (b = 0; b < nBuckets; b++) {
+        long n = bucketSize[b], pos = 0, i;
+        int firstDst = dst;
+        for (; dst < nURLs && bucketOf[dst] == b; dst++) {
+            offset[dst] = pos;
+            pos += inDegree[dst];
+        }
+        if (dst - firstDst == 1) {
+            bucketName(name, fileName, b);
+            FILE *bucket = openOrDie(name, "rb");
+            copyBucket(bucket, name, n, out);
+            fclose(bucket);
+            remove(name);
+            continue;
+        }
+        EdgeRecord *unsorted = malloc((n + 1) * sizeof(EdgeRecord));
+        EdgeRecord *sorted = malloc((n + 1) * sizeof(EdgeRecord));
+        assert(unsorted != NULL && sorted != NULL);
+        bucketName(name, fileName, b);
+        FILE *bucket = openOrDie(name, "rb");
+        if (fread(unsorted, sizeof(EdgeRecord), n, bucket) != (size_t)n) {
+            fprintf(stderr, "%s: short read\n", name);
+            exit(EXIT_FAILURE);
+        }
+        fclose(bucket);
+        remove(name);
+        for (i = 0; i < n; i++)
+            sorted[offset[unsorted[i].dst]++] = unsorted[i];
+        writeOrDie(sorted, sizeof(EdgeRecord), n, out);
+        free(unsorted); free(sorted);
+    }
+    free(offset);
+}
+
+
+long buildEdgeFile(Set URLList, char *fileName, int *outDegree, int memMB)
+{
+    int nURLs = nElems(URLList);
+    int i;
+    // URL name -> position in the collection
+    HashMap ids = newHashMap(nURLs);
+    SetNode curr = URLList->elems;
+    for (i = 0; curr != NULL; curr = curr->next, i++) hashMapPut(ids, curr->val, i);
+
+    int *inDegree = calloc(nURLs, sizeof(int));
+    int *bucketOf = malloc(nURLs * sizeof(int));
+    long *bucketSize = calloc(nURLs + 1, sizeof(long));
+    assert(inDegree != NULL && bucketOf != NULL && bucketSize != NULL);
+    for (i = 0; i < nURLs; i++) outDegree[i] = 0;
+
+    char rawName[URL_LENGTH + NAME_SPACE];
+    sprintf(rawName, "%s.raw", fileName);
+    FILE *raw = openOrDie(rawName, "w+b");
+    long nEdges = writeRawEdges(URLList, ids, raw, outDegree, inDegree);
+    disposeHashMap(ids);
+    if (fflush(raw) != 0 || ferror(raw)) { perror("fwrite failed"); exit(EXIT_FAILURE); }
+
+    long maxEdges = (long)memMB * MB / (2 * sizeof(EdgeRecord));
+    if (maxEdges < 1) maxEdges = 1;
+    int nBuckets = assignBuckets(inDegree, nURLs, maxEdges, bucketOf, bucketSize);
+    writeBuckets(raw, fileName, nBuckets, maxOpenBuckets(memMB), outDegree, inDegree, bucketOf);
+    fclose(raw);
+    remove(rawName);
+
+    // written under another name and renamed, so a failed build never
+    // leaves a truncated edge file behind
+    char tmpName[URL_LENGTH + NAME_SPACE];
+    FILE *out = openTemp(fileName, tmpName, URL_LENGTH + NAME_SPACE);
+    EdgeFileHeader header = { EDGE_MAGIC, nURLs, nEdges };
+    writeOrDie(&header, sizeof(EdgeFileHeader), 1, out);
+    mergeBuckets(out, fileName, nBuckets, bucketSize, inDegree, bucketOf, nURLs);
+    if (!commitTemp(out, tmpName, fileName)) { perror("edge file not written"); exit(EXIT_FAILURE); }
+
+    free(inDegree); free(bucketOf); free(bucketSize);
+    return nEdges;
+}
+
+
+FILE *openEdgeFile(char *fileName, EdgeFileHeader *header)
+{
+    FILE *file = openOrDie(fileName, "rb");
+    if (fread(header, sizeof(EdgeFileHeader), 1, file) != 1 || header->magic != EDGE_MAGIC) {
+        fprintf(stderr, "%s: not an edge file\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) != sizeof(EdgeFileHeader) + header->nEdges * sizeof(EdgeRecord)) {
+        fprintf(stderr, "%s: truncated edge file\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    fseek(file, sizeof(EdgeFileHeader), SEEK_SET);
+    return file;
+}
+
+
+// the URL the sweep is at has all its in-links summed
+static void updateNext(EdgeSweep *sweep, double *ranks)
+{
+    int v = sweep->next++;
+    double curr = (1 - sweep->damp)/sweep->nURLs + sweep->damp * sweep->sum;
+    sweep->residual += fabs(curr - ranks[v]);
+    // as calculateDiffPR: the change of this URL, added up nURLs times
+    sweep->lastDiff = sweep->nURLs * fabs(curr - ranks[v]);
+    ranks[v] = curr;
+    sweep->sum = 0;
+}
+
+
+void startSweep(EdgeSweep *sweep, int first, int nURLs, double damp)
+{
+    sweep->next = first;
+    sweep->nURLs = nURLs;
+    sweep->damp = damp;
+    sweep->sum = 0;
+    sweep->residual = 0;
+    sweep->lastDiff = 0;
+}
+
+
+void sweepEdges(EdgeSweep *sweep, EdgeRecord *records, long n, double *ranks)
+{
+    long k;
+    for (k = 0; k < n; k++) {
+        while (sweep->next < records[k].dst) updateNext(sweep, ranks);
+        // lower IDs already hold this iteration's ranks, higher the last
+        sweep->sum += ranks[records[k].src] * records[k].weight;
+    }
+}
+
+
+void finishSweep(EdgeSweep *sweep, int end, double *ranks)
+{
+    while (sweep->next < end) updateNext(sweep, ranks);
+}
+
+
+int streamPageRank(char *fileName, double damp, double diffPR, int maxIterations,
+                   double *ranks, PRTrace trace)
+{
+    EdgeFileHeader header;
+    FILE *file = openEdgeFile(fileName, &header);
+    int nURLs = header.nURLs;
+    EdgeRecord *batch = malloc(READ_BATCH * sizeof(EdgeRecord));
+    assert(batch != NULL);
+    int i;
+    for (i = 0; i < nURLs; i++) ranks[i] = 1.0/nURLs;
+
+    int iter = 0;
+    double diff = diffPR;
+    traceStartIterations(trace);
+    while (iter < maxIterations && diff >= diffPR) {
+        EdgeSweep sweep;
+        startSweep(&sweep, 0, nURLs, damp);
+        // one sequential pass over the in-links
+        fseek(file, sizeof(EdgeFileHeader), SEEK_SET);
+        size_t n;
+        while ((n = fread(batch, sizeof(EdgeRecord), READ_BATCH, file)) > 0)
+            sweepEdges(&sweep, batch, n, ranks);
+        finishSweep(&sweep, nURLs, ranks);
+        diff = sweep.lastDiff;
+        traceIteration(trace, sweep.residual, header.nEdges);
+        iter++;
+    }
+    free(batch);
+    fclose(file);
+    return iter;
+}
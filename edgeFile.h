@@ -0,0 +1,77 @@
+/* edgeFile.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Out-of-core representation of the weighted link graph. Every in-link
+ * is stored as a fixed size record sorted by destination so one PageRank
+ * iteration is a single sequential scan of the file.
+ */
+
+#include <stdio.h>
+#include "set.h"
+#include "prTrace.h"
+
+#ifndef EDGEFILE_H
+#define EDGEFILE_H
+
+#define EDGE_MAGIC      0x31524445  // "EDR1"
+#define DEFAULT_MEM_MB  64
+
+typedef struct edgeRecord {
+    int    src;
+    int    dst;
+    double weight;   // Win(src, dst) * Wout(src, dst)
+} EdgeRecord;
+
+typedef struct edgeFileHeader {
+    int  magic;
+    int  nURLs;
+    long nEdges;
+} EdgeFileHeader;
+
+/* One PageRank iteration with the updates of PageRankW in pagerank.c,
+ * fed in-link records in the order of the edge file: each rank is
+ * overwritten as soon as all its in-links are summed, in ID order.
+ */
+typedef struct edgeSweep {
+    int    next;        // next URL to update
+    int    nURLs;
+    double damp;
+    double sum;         // in-links of next summed so far
+    double residual;    // sum of the changes so far
+    double lastDiff;    // change of the last URL updated times nURLs
+} EdgeSweep;
+
+/* Parses every page in URLList and writes the weighted in-links to
+ * fileName sorted by destination, holding at most memMB of edges in
+ * memory at a time. URL IDs are positions in URLList. Fills outDegree
+ * (size nElems(URLList)) and returns the number of edges written.
+ */
+long buildEdgeFile(Set URLList, char *fileName, int *outDegree, int memMB);
+
+/* Opens the edge file fileName and reads its header, exiting if it is
+ * not an edge file or holds fewer records than the header says. The
+ * file is left positioned at the first record.
+ */
+FILE *openEdgeFile(char *fileName, EdgeFileHeader *header);
+
+// starts a sweep that updates URLs from first on
+void startSweep(EdgeSweep *, int first, int nURLs, double damp);
+/* Adds n records sorted by destination, none before the URL the sweep
+ * is at, updating every URL before the last record's destination.
+ */
+void sweepEdges(EdgeSweep *, EdgeRecord *records, long n, double *ranks);
+// updates the URLs left before end
+void finishSweep(EdgeSweep *, int end, double *ranks);
+
+/* Runs weighted PageRank by scanning fileName once per iteration, with
+ * the same updates and stop rule as PageRankW in pagerank.c, so the
+ * ranks are the same. Only the rank vector is kept in memory; final
+ * ranks go in ranks. Iterations are recorded in trace (may be NULL).
+ * Returns the number of iterations performed.
+ */
+int streamPageRank(char *fileName, double damp, double diffPR,
+                   int maxIterations, double *ranks, PRTrace trace);
+
+#endif
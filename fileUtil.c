@@ -0,0 +1,46 @@
+/* fileUtil.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Implementation of fileUtil.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "fileUtil.h"
+
+#define TRUE        1
+#define FALSE       0
+#define NS_PER_SEC  1000000000L
+
+
+int fileVersion(char *fileName, long *size, long *time)
+{
+    struct stat st;
+    if (stat(fileName, &st) != 0) return FALSE;
+    *size = st.st_size;
+    *time = st.st_mtim.tv_sec * NS_PER_SEC + st.st_mtim.tv_nsec;
+    return TRUE;
+}
+
+
+FILE *openTemp(char *fileName, char *tmpName, int size)
+{
+    snprintf(tmpName, size, "%s%s", fileName, TEMP_SUFFIX);
+    FILE *file = fopen(tmpName, "wb");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    return file;
+}
+
+
+int commitTemp(FILE *file, char *tmpName, char *fileName)
+{
+    int ok = !ferror(file);
+    if (fclose(file) != 0) ok = FALSE;
+    if (ok && rename(tmpName, fileName) == 0) return TRUE;
+    remove(tmpName);
+    return FALSE;
+}
@@ -0,0 +1,33 @@
+/* fileUtil.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * File helpers shared by the binary caches (graph snapshot, rank table,
+ * page archive, term dictionary and edge file): the version a cache
+ * records of the file it was built from, and writing a cache under a
+ * temporary name that is renamed into place once complete, so a reader
+ * never maps half a file and a failed build never leaves one behind.
+ */
+
+#ifndef FILEUTIL_H
+#define FILEUTIL_H
+
+#include <stdio.h>
+
+#define TEMP_SUFFIX     ".tmp"
+
+// size and modification time (ns) of fileName, FALSE if it does not exist
+int fileVersion(char *fileName, long *size, long *time);
+
+/* Opens fileName.tmp for writing, leaving its name in tmpName (size
+ * bytes). Exits on failure.
+ */
+FILE *openTemp(char *fileName, char *tmpName, int size);
+/* Closes file and renames tmpName to fileName. On a write, close or
+ * rename error tmpName is removed, fileName is left as it was and FALSE
+ * is returned.
+ */
+int commitTemp(FILE *file, char *tmpName, char *fileName);
+
+#endif
@@ -0,0 +1,74 @@
+/* footrule.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * A cost row is built one list at a time: for a normalised position x
+ * every slot gets |x - slots[p]| added, which is a subtract and a
+ * sign-bit clear per element. With SSE2 (always there on x86-64) that
+ * is two positions per instruction, four with AVX, and the row is
+ * written sequentially so building the matrix is limited by memory
+ * bandwidth rather than by divides or function calls.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "footrule.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+double *footruleSlots(int n)
+{
+    double *slots = malloc((n + 1) * sizeof(double));
+    assert(slots != NULL);
+    int p;
+    for (p = 0; p < n; p++) slots[p] = (p + 1) / (double)n;
+    return slots;
+}
+
+
+// adds |x - slots[p]| to row[p] for every p
+static void addDistances(double *row, double x, double *slots, int n)
+{
+    int p = 0;
+#if defined(__AVX__)
+    __m256d vx = _mm256_set1_pd(x);
+    __m256d sign = _mm256_set1_pd(-0.0);
+    for (; p + 4 <= n; p += 4) {
+        __m256d d = _mm256_sub_pd(vx, _mm256_loadu_pd(slots + p));
+        d = _mm256_andnot_pd(sign, d);
+        _mm256_storeu_pd(row + p, _mm256_add_pd(_mm256_loadu_pd(row + p), d));
+    }
+#elif defined(__SSE2__)
+    __m128d vx = _mm_set1_pd(x);
+    __m128d sign = _mm_set1_pd(-0.0);
+    for (; p + 2 <= n; p += 2) {
+        __m128d d = _mm_sub_pd(vx, _mm_loadu_pd(slots + p));
+        d = _mm_andnot_pd(sign, d);
+        _mm_storeu_pd(row + p, _mm_add_pd(_mm_loadu_pd(row + p), d));
+    }
+#endif
+    for (; p < n; p++) row[p] += fabs(x - slots[p]);
+}
+
+
+void footruleRow(double *row, double *norm, int nNorm, double *slots, int n)
+{
+    int p, k;
+    for (p = 0; p < n; p++) row[p] = 0;
+    for (k = 0; k < nNorm; k++) addDistances(row, norm[k], slots, n);
+}
+
+
+double footruleCost(double *norm, int nNorm, double slot)
+{
+    double sum = 0;
+    int k;
+    for (k = 0; k < nNorm; k++) sum += fabs(norm[k] - slot);
+    return sum;
+}
@@ -0,0 +1,22 @@
+/* footrule.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Scaled footrule cost kernels shared by the rank aggregation code.
+ * The cost of putting a URL at position p out of n is
+ *      sum over the lists c containing it of | tau(c)/|tau| - p/n |
+ * where tau(c)/|tau| is its normalised position in list tau.
+ */
+
+#ifndef FOOTRULE_H
+#define FOOTRULE_H
+
+// slots[p] = (p+1)/n for p = 0 .. n-1; caller frees
+double *footruleSlots(int n);
+// row[p] = sum over k of |norm[k] - slots[p]| for p = 0 .. n-1
+void footruleRow(double *row, double *norm, int nNorm, double *slots, int n);
+// cost of a single position (slot = p/n)
+double footruleCost(double *norm, int nNorm, double slot);
+
+#endif
@@ -0,0 +1,255 @@
+/* genCollection.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Writes a synthetic collection (collection.txt and one urlN.txt page per
+ * URL in the #start Section-1 / Section-2 format) for testing the tools
+ * at scale. The same arguments and seed always give the same files.
+ *  - Out-degrees are power law: a few hub pages link to many others.
+ *  - Link targets are picked in proportion to a power law popularity,
+ *    so in-degrees are power law too.
+ *  - Page text is drawn from a vocabulary of made up words with Zipfian
+ *    frequencies: the word of rank r is used in proportion to 1 / r^s.
+ *    Sentences start with a capital and end in '.', like real text, so
+ *    normalise() has something to do.
+ *
+ * Usage: ./genCollection nPages [--seed=N] [--dir=DIR] [--vocab=N]
+ *        [--words=N] [--links=N] [--alpha=X] [--zipf=X]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "rng.h"
+
+#define REQUIRED_ARGS   2
+#define DEFAULT_SEED    42
+#define DEFAULT_VOCAB   10000
+#define DEFAULT_WORDS   200     // mean words per page
+#define DEFAULT_LINKS   8       // mean outlinks per page
+#define DEFAULT_ALPHA   2.1     // degree power law exponent
+#define DEFAULT_ZIPF    1.0
+#define MAX_WORD        16
+#define MAX_PATH        4096
+#define LINE_WIDTH      72      // readPage reads lines of up to 1000 chars
+#define SENTENCE_LEN    12      // mean words per sentence
+#define INDENT          "    "
+#define SEED_FLAG       "--seed="
+#define DIR_FLAG        "--dir="
+#define VOCAB_FLAG      "--vocab="
+#define WORDS_FLAG      "--words="
+#define LINKS_FLAG      "--links="
+#define ALPHA_FLAG      "--alpha="
+#define ZIPF_FLAG       "--zipf="
+
+static unsigned long long rngState;
+
+static char *consonants = "bcdfghjklmnprstvwz";
+static char *vowels = "aeiou";
+
+
+/* Pareto sample with the given exponent (> 2) scaled to have the given
+ * mean, rounded and capped at max. Near alpha = 2 the mean is carried by
+ * rare huge values, so small collections come out below it.
+ */
+static int powerLaw(double alpha, double mean, int max)
+{
+    double xMin = mean * (alpha - 2) / (alpha - 1);
+    double x = xMin * pow(uniformOpen(&rngState), -1 / (alpha - 1)) + 0.5;
+    return x > max ? max : (int)x;
+}
+
+
+// cumulative weights, so weighted picks are a binary search
+static double *cumulative(double *weight, int n)
+{
+    double *cdf = malloc(n * sizeof(double));
+    assert(cdf != NULL);
+    double sum = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        sum += weight[i];
+        cdf[i] = sum;
+    }
+    return cdf;
+}
+
+
+// index i picked with probability weight[i] / total
+static int pick(double *cdf, int n)
+{
+    double x = uniformOpen(&rngState) * cdf[n - 1];
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (cdf[mid] < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+
+/* The word of rank r: r written in base (consonants x vowels) as
+ * syllables, so every rank gets a different pronounceable word.
+ */
+static void makeWord(int r, char *word)
+{
+    int nC = strlen(consonants), nV = strlen(vowels), len = 0;
+    do {
+        int syllable = r % (nC * nV);
+        word[len++] = consonants[syllable / nV];
+        word[len++] = vowels[syllable % nV];
+        r /= nC * nV;
+    } while (r > 0);
+    word[len] = '\0';
+}
+
+
+static void writeCollection(char *dir, int nPages)
+{
+    char path[MAX_PATH];
+    snprintf(path, MAX_PATH, "%s/collection.txt", dir);
+    FILE *file = fopen(path, "w");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    int i;
+    for (i = 0; i < nPages; i++)
+        fprintf(file, "url%d%s", i, (i + 1) % 8 == 0 ? "\n" : " ");
+    fprintf(file, "\n");
+    fclose(file);
+}
+
+
+// appends item to the current line, starting a new one when it is full
+static void writeItem(FILE *file, char *item, int *column)
+{
+    int len = strlen(item);
+    if (*column > 0 && *column + len + 1 > LINE_WIDTH) {
+        fprintf(file, "\n");
+        *column = 0;
+    }
+    if (*column == 0) {
+        fprintf(file, INDENT);
+        *column = strlen(INDENT);
+    }
+    fprintf(file, "%s ", item);
+    *column += len + 1;
+}
+
+
+/* Writes page p. linkedFrom marks the targets already used so a page
+ * links to each other page at most once.
+ */
+static void writePage(char *dir, int p, int nPages, double *popularity,
+                      double *wordFreq, char **words, int vocab,
+                      int meanWords, int meanLinks, double alpha, int *linkedFrom)
+{
+    char path[MAX_PATH], item[MAX_WORD + 16];
+    snprintf(path, MAX_PATH, "%s/url%d.txt", dir, p);
+    FILE *file = fopen(path, "w");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+
+    fprintf(file, "#start Section-1\n\n");
+    int nLinks = powerLaw(alpha, meanLinks, nPages - 1);
+    int i, column = 0, tries = 0;
+    for (i = 0; i < nLinks && tries < 4 * nLinks + 16; tries++) {
+        int q = pick(popularity, nPages);
+        if (q == p || linkedFrom[q] == p) continue;
+        linkedFrom[q] = p;
+        sprintf(item, "url%d", q);
+        writeItem(file, item, &column);
+        i++;
+    }
+    fprintf(file, "\n\n#end Section-1\n\n#start Section-2\n\n");
+
+    // page lengths vary between half and one and a half times the mean
+    int nWords = meanWords / 2 + nextRandom(&rngState) % (meanWords + 1);
+    int startSentence = 1;
+    column = 0;
+    for (i = 0; i < nWords; i++) {
+        strcpy(item, words[pick(wordFreq, vocab)]);
+        if (startSentence) item[0] = item[0] - 'a' + 'A';
+        startSentence = i == nWords - 1 || nextRandom(&rngState) % SENTENCE_LEN == 0;
+        if (startSentence) strcat(item, ".");
+        writeItem(file, item, &column);
+    }
+    fprintf(file, "\n\n#end Section-2\n");
+    fclose(file);
+}
+
+
+int main(int argc, char **argv)
+{
+    if (argc < REQUIRED_ARGS || atoi(argv[1]) < 1) {
+        printf("Usage: ./genCollection nPages [--seed=N] [--dir=DIR] [--vocab=N] "
+               "[--words=N] [--links=N] [--alpha=X] [--zipf=X]\n");
+        exit(EXIT_FAILURE);
+    }
+    int nPages = atoi(argv[1]);
+    unsigned long long seed = DEFAULT_SEED;
+    char *dir = ".";
+    int vocab = DEFAULT_VOCAB, meanWords = DEFAULT_WORDS, meanLinks = DEFAULT_LINKS;
+    double alpha = DEFAULT_ALPHA, zipf = DEFAULT_ZIPF;
+    int i;
+    for (i = REQUIRED_ARGS; i < argc; i++) {
+        if (strncmp(argv[i], SEED_FLAG, strlen(SEED_FLAG)) == 0) {
+            seed = strtoull(argv[i] + strlen(SEED_FLAG), NULL, 10);
+        } else if (strncmp(argv[i], DIR_FLAG, strlen(DIR_FLAG)) == 0) {
+            dir = argv[i] + strlen(DIR_FLAG);
+        } else if (strncmp(argv[i], VOCAB_FLAG, strlen(VOCAB_FLAG)) == 0) {
+            vocab = atoi(argv[i] + strlen(VOCAB_FLAG));
+        } else if (strncmp(argv[i], WORDS_FLAG, strlen(WORDS_FLAG)) == 0) {
+            meanWords = atoi(argv[i] + strlen(WORDS_FLAG));
+        } else if (strncmp(argv[i], LINKS_FLAG, strlen(LINKS_FLAG)) == 0) {
+            meanLinks = atoi(argv[i] + strlen(LINKS_FLAG));
+        } else if (strncmp(argv[i], ALPHA_FLAG, strlen(ALPHA_FLAG)) == 0) {
+            alpha = atof(argv[i] + strlen(ALPHA_FLAG));
+        } else if (strncmp(argv[i], ZIPF_FLAG, strlen(ZIPF_FLAG)) == 0) {
+            zipf = atof(argv[i] + strlen(ZIPF_FLAG));
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (vocab < 1 || meanWords < 1 || meanLinks < 1 || alpha <= 2) {
+        fprintf(stderr, "--vocab, --words and --links must be positive "
+                        "and --alpha greater than 2\n");
+        exit(EXIT_FAILURE);
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        perror("mkdir failed");
+        exit(EXIT_FAILURE);
+    }
+    rngState = seedRandom(seed);
+
+    char **words = malloc(vocab * sizeof(char *));
+    double *weight = malloc((nPages > vocab ? nPages : vocab) * sizeof(double));
+    assert(words != NULL && weight != NULL);
+    for (i = 0; i < vocab; i++) {
+        words[i] = malloc(MAX_WORD);
+        assert(words[i] != NULL);
+        makeWord(i, words[i]);
+        weight[i] = 1 / pow(i + 1, zipf);
+    }
+    double *wordFreq = cumulative(weight, vocab);
+    for (i = 0; i < nPages; i++) weight[i] = powerLaw(alpha, 1, nPages) + 1;
+    double *popularity = cumulative(weight, nPages);
+    free(weight);
+
+    int *linkedFrom = malloc(nPages * sizeof(int));
+    assert(linkedFrom != NULL);
+    for (i = 0; i < nPages; i++) linkedFrom[i] = -1;
+    writeCollection(dir, nPages);
+    for (i = 0; i < nPages; i++)
+        writePage(dir, i, nPages, popularity, wordFreq, words, vocab,
+                  meanWords, meanLinks, alpha, linkedFrom);
+
+    for (i = 0; i < vocab; i++) free(words[i]);
+    free(words); free(wordFreq); free(popularity); free(linkedFrom);
+    return 0;
+}
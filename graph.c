@@ -12,6 +12,7 @@
 #include <string.h>
 #include "graph.h"
 #include "mystring.h"
+#include "stats.h"
 
 #define NULL_TERM 1
 
@@ -20,6 +21,7 @@
 struct urlLink *newInLink(URL PointTo)
 {
     struct urlLink *newLink = calloc(1, sizeof(struct urlLink));
+    STATS_ADD(STAT_ALLOCS, 1);
     newLink->URLName = mystrdup(PointTo->URLName);
     newLink->URLPointer = PointTo;
     newLink->next = NULL;
@@ -31,6 +33,7 @@ struct urlLink *newInLink(URL PointTo)
 struct urlLink *newOutLink(char *URLName)
 {
     struct urlLink *newLink = calloc(1, sizeof(struct urlLink));
+    STATS_ADD(STAT_ALLOCS, 1);
     newLink->URLName = mystrdup(URLName);
     newLink->URLPointer = NULL;
     newLink->next = NULL;
@@ -42,6 +45,7 @@ struct urlLink *newOutLink(char *URLName)
 struct urlNode *newGraphNode(char *urlNum, char *text)
 {
     struct urlNode *newURL = calloc(1, sizeof(struct urlNode));
+    STATS_ADD(STAT_ALLOCS, 1);
     newURL->URLName = mystrdup(urlNum);
     newURL->numOutLinks = 0; newURL->numInLinks = 0;
     newURL->text = mystrdup(text);
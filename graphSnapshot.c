@@ -0,0 +1,216 @@
+/* graphSnapshot.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * FILE LAYOUT:
+ *  SnapshotHeader
+ *  long pageSize[nURLs]        size and modification time (ns) of each
+ *  long pageTime[nURLs]        page when the snapshot was saved
+ *  long outStart[nURLs + 1]
+ *  int  outLinks[nURLs]
+ *  int  outDst[nEdges]
+ *  char names[namesSize]       the URLs, each NUL-terminated, in ID order
+ * Everything is in the machine's own byte order; a snapshot is only a
+ * cache of the pages it was made from.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graphSnapshot.h"
+#include "pageArchive.h"
+#include "hashMap.h"
+#include "stats.h"
+#include "fileUtil.h"
+
+#define TRUE            1
+#define FALSE           0
+#define COLLECTION_FILE "collection.txt"
+#define MAX_NAME        1024
+
+typedef struct snapshotHeader {
+    int  magic;
+    int  nURLs;
+    long nEdges;
+    long namesSize;
+    long collectionSize;    // version of collection.txt when saved
+    long collectionTime;
+} SnapshotHeader;
+
+
+/* Version of the page the tools read for URLName: the copy in archive
+ * (may be NULL) when openPage would read it, otherwise its file.
+ */
+static int pageVersion(PageArchive archive, char *URLName, long *size, long *time)
+{
+    char fileName[MAX_NAME];
+    snprintf(fileName, MAX_NAME, "%s.txt", URLName);
+    int id = archive != NULL ? archiveFind(archive, URLName) : -1;
+    if (id >= 0 && archivePageCurrent(archive, id, fileName)) {
+        archivePageVersion(archive, id, size, time);
+        return TRUE;
+    }
+    return fileVersion(fileName, size, time);
+}
+
+
+static long snapshotSize(SnapshotHeader *h)
+{
+    return sizeof(SnapshotHeader) + (3L * h->nURLs + 1) * sizeof(long)
+         + (h->nURLs + h->nEdges) * sizeof(int) + h->namesSize;
+}
+
+
+void saveGraphSnapshot(Graph web, char *fileName)
+{
+    int n = web->numURLs, i;
+    SnapshotHeader h = { SNAPSHOT_MAGIC, n, 0, 0, 0, 0 };
+    long *pageSize = malloc((n + 1) * sizeof(long));
+    long *pageTime = malloc((n + 1) * sizeof(long));
+    long *outStart = malloc((n + 1) * sizeof(long));
+    int *outLinks = malloc((n + 1) * sizeof(int));
+    assert(pageSize != NULL && pageTime != NULL && outStart != NULL && outLinks != NULL);
+    // a page that cannot be checked later would make the snapshot useless
+    int ok = fileVersion(COLLECTION_FILE, &h.collectionSize, &h.collectionTime);
+    char *unchecked = COLLECTION_FILE;
+    PageArchive archive = openArchive(ARCHIVE_FILE, COLLECTION_FILE);
+    HashMap ids = newHashMap(n);
+    for (i = 0; i < n && ok; i++) {
+        URL node = web->listOfUrls[i];
+        ok = pageVersion(archive, node->URLName, &pageSize[i], &pageTime[i]);
+        if (!ok) unchecked = node->URLName;
+        hashMapPut(ids, node->URLName, i);
+        h.nEdges += node->numOutLinks;
+        h.namesSize += strlen(node->URLName) + 1;
+    }
+    int *outDst = malloc((h.nEdges + 1) * sizeof(int));
+    assert(outDst != NULL);
+    // the same links, in the same order, as graphToLinkGraph takes
+    long e = 0;
+    for (i = 0; i < n && ok; i++) {
+        outStart[i] = e;
+        outLinks[i] = web->listOfUrls[i]->numOutLinks;
+        Link curr = web->listOfUrls[i]->outLink;
+        for (; curr != NULL; curr = curr->next) {
+            int d = hashMapGet(ids, curr->URLName);
+            if (d != NOT_FOUND) outDst[e++] = d;
+        }
+    }
+    outStart[n] = h.nEdges = e;
+
+    if (ok) {
+        // written under another name and renamed, so a run that starts
+        // meanwhile never maps half a snapshot
+        char tmpName[MAX_NAME];
+        FILE *file = openTemp(fileName, tmpName, MAX_NAME);
+        fwrite(&h, sizeof(SnapshotHeader), 1, file);
+        fwrite(pageSize, sizeof(long), n, file);
+        fwrite(pageTime, sizeof(long), n, file);
+        fwrite(outStart, sizeof(long), n + 1, file);
+        fwrite(outLinks, sizeof(int), n, file);
+        fwrite(outDst, sizeof(int), e, file);
+        for (i = 0; i < n; i++) {
+            char *name = web->listOfUrls[i]->URLName;
+            fwrite(name, 1, strlen(name) + 1, file);
+        }
+        commitTemp(file, tmpName, fileName);
+    } else {
+        fprintf(stderr, "%s not saved: %s cannot be checked\n", fileName, unchecked);
+    }
+    closeArchive(archive);
+    disposeHashMap(ids);
+    free(pageSize); free(pageTime); free(outStart); free(outLinks); free(outDst);
+}
+
+
+GraphSnapshot loadGraphSnapshot(char *fileName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+    STATS_ADD(STAT_FILES, 1);
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= sizeof(SnapshotHeader))
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    SnapshotHeader *h = map;
+    long size, time;
+    int valid = h->magic == SNAPSHOT_MAGIC && h->nURLs >= 0 && h->nEdges >= 0
+             && h->namesSize >= 0 && snapshotSize(h) == st.st_size
+             && fileVersion(COLLECTION_FILE, &size, &time)
+             && size == h->collectionSize && time == h->collectionTime;
+    GraphSnapshot snap = NULL;
+    if (valid) {
+        PageArchive archive = openArchive(ARCHIVE_FILE, COLLECTION_FILE);
+        int n = h->nURLs, i;
+        snap = calloc(1, sizeof(struct graphSnapshot));
+        assert(snap != NULL);
+        snap->nURLs = n;
+        snap->nEdges = h->nEdges;
+        snap->map = map;
+        snap->mapSize = st.st_size;
+        long *pageSize = (long *)(h + 1);
+        long *pageTime = pageSize + n;
+        snap->outStart = pageTime + n;
+        snap->outLinks = (int *)(snap->outStart + n + 1);
+        snap->outDst = snap->outLinks + n;
+        char *names = (char *)(snap->outDst + h->nEdges);
+        char *end = names + h->namesSize;
+        snap->names = malloc((n + 1) * sizeof(char *));
+        assert(snap->names != NULL);
+        for (i = 0; i < n && valid; i++) {
+            snap->names[i] = names;
+            names += strnlen(names, end - names) + 1;
+            valid = names <= end
+                 && snap->outStart[i] <= snap->outStart[i + 1]
+                 && pageVersion(archive, snap->names[i], &size, &time)
+                 && size == pageSize[i] && time == pageTime[i];
+        }
+        valid = valid && snap->outStart[0] == 0 && snap->outStart[n] == h->nEdges;
+        for (i = 0; i < h->nEdges && valid; i++)
+            valid = snap->outDst[i] >= 0 && snap->outDst[i] < n;
+        STATS_ADD(STAT_BYTES, st.st_size);
+        closeArchive(archive);
+    }
+    if (!valid) {
+        if (snap != NULL) {
+            free(snap->names);
+            free(snap);
+        }
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    return snap;
+}
+
+
+void freeGraphSnapshot(GraphSnapshot snap)
+{
+    if (snap == NULL) return;
+    munmap(snap->map, snap->mapSize);
+    free(snap->names);
+    free(snap);
+}
+
+
+LinkGraph snapshotLinkGraph(GraphSnapshot snap)
+{
+    int *src = malloc((snap->nEdges + 1) * sizeof(int));
+    assert(src != NULL);
+    int v;
+    long e;
+    for (v = 0; v < snap->nURLs; v++)
+        for (e = snap->outStart[v]; e < snap->outStart[v + 1]; e++) src[e] = v;
+    LinkGraph g = newLinkGraph(snap->nURLs, snap->nEdges, src, snap->outDst);
+    free(src);
+    return g;
+}
@@ -0,0 +1,44 @@
+/* graphSnapshot.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Binary copy of the link graph getGraph builds: the URL table and the
+ * out-links in CSR form. It is saved after a parse and memory mapped by
+ * later runs, as long as collection.txt and every page still have the
+ * size and modification time they had when it was saved. A page the
+ * tools read from collection.pack (see openPage) is checked against the
+ * version recorded there instead of its file.
+ */
+
+#include "graph.h"
+#include "linkGraph.h"
+
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#define SNAPSHOT_MAGIC  0x31534752  // "RGS1"
+#define GRAPH_SNAPSHOT  "pagerankGraph.bin"
+
+typedef struct graphSnapshot *GraphSnapshot;
+
+struct graphSnapshot {
+    int    nURLs;
+    long   nEdges;
+    char **names;       // URL of each ID, in getCollection order
+    int   *outLinks;    // numOutLinks of each ID
+    long  *outStart;    // links of v go to outDst[outStart[v] .. outStart[v+1]-1]
+    int   *outDst;
+    void  *map;         // the arrays point into the mapped file
+    long   mapSize;
+};
+
+// writes web, parsed from collection.txt and the pages as they are now
+void saveGraphSnapshot(Graph web, char *fileName);
+// maps fileName, NULL if it is missing, not a snapshot, or out of date
+GraphSnapshot loadGraphSnapshot(char *fileName);
+void freeGraphSnapshot(GraphSnapshot);
+// the link graph graphToLinkGraph would build from the parsed graph
+LinkGraph snapshotLinkGraph(GraphSnapshot);
+
+#endif
@@ -0,0 +1,126 @@
+/* hashMap.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * String -> int map using open addressing with linear probing.
+ * The table is kept at most half full so probes stay short.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hashMap.h"
+#include "mystring.h"
+
+#define MIN_SLOTS   16
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+struct hashMap {
+    int    nKeys;
+    int    nSlots;   // always a power of two
+    char **keys;     // NULL marks an empty slot
+    int   *values;
+};
+
+
+/* FNV-1a hash of a string. */
+unsigned int hashString(char *str)
+{
+    unsigned int h = FNV_OFFSET;
+    for (; *str != '\0'; str++) {
+        h ^= (unsigned char)*str;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+
+// allocates an empty table with nSlots slots
+static void allocSlots(HashMap m, int nSlots)
+{
+    m->nSlots = nSlots;
+    m->keys = calloc(nSlots, sizeof(char *));
+    m->values = malloc(nSlots * sizeof(int));
+    assert(m->keys != NULL && m->values != NULL);
+}
+
+
+// finds the slot holding key, or the empty slot where it would go
+static int findSlot(HashMap m, char *key)
+{
+    int mask = m->nSlots - 1;
+    int slot = hashString(key) & mask;
+    while (m->keys[slot] != NULL && strcmp(m->keys[slot], key) != 0)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+
+// doubles the table and re-inserts every key
+static void grow(HashMap m)
+{
+    char **oldKeys = m->keys;
+    int *oldValues = m->values;
+    int oldSlots = m->nSlots;
+    allocSlots(m, oldSlots * 2);
+    int i;
+    for (i = 0; i < oldSlots; i++) {
+        if (oldKeys[i] == NULL) continue;
+        int slot = findSlot(m, oldKeys[i]);
+        m->keys[slot] = oldKeys[i];
+        m->values[slot] = oldValues[i];
+    }
+    free(oldKeys); free(oldValues);
+}
+
+
+HashMap newHashMap(int nKeys)
+{
+    HashMap m = malloc(sizeof(struct hashMap));
+    assert(m != NULL);
+    int nSlots = MIN_SLOTS;
+    while (nSlots < nKeys * 2) nSlots *= 2;
+    m->nKeys = 0;
+    allocSlots(m, nSlots);
+    return m;
+}
+
+
+void disposeHashMap(HashMap m)
+{
+    if (m == NULL) return;
+    int i;
+    for (i = 0; i < m->nSlots; i++) free(m->keys[i]);
+    free(m->keys); free(m->values);
+    free(m);
+}
+
+
+void hashMapPut(HashMap m, char *key, int value)
+{
+    assert(m != NULL);
+    if ((m->nKeys + 1) * 2 > m->nSlots) grow(m);
+    int slot = findSlot(m, key);
+    if (m->keys[slot] == NULL) {
+        m->keys[slot] = mystrdup(key);
+        m->nKeys++;
+    }
+    m->values[slot] = value;
+}
+
+
+int hashMapGet(HashMap m, char *key)
+{
+    assert(m != NULL);
+    int slot = findSlot(m, key);
+    return m->keys[slot] == NULL ? NOT_FOUND : m->values[slot];
+}
+
+
+int hashMapSize(HashMap m)
+{
+    assert(m != NULL);
+    return m->nKeys;
+}
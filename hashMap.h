@@ -0,0 +1,30 @@
+/* hashMap.h ... interface to a string -> int hash map
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Open addressing hash map used to turn URL names into dense IDs
+ * without the linear strcmp scans of the Set ADT.
+ */
+
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#define NOT_FOUND -1
+
+typedef struct hashMap *HashMap;
+
+// create an empty map sized for about nKeys keys
+HashMap newHashMap(int nKeys);
+// free memory associated with the map and its keys
+void disposeHashMap(HashMap);
+// insert key (copied) with value, replacing any previous value
+void hashMapPut(HashMap, char *, int);
+// value stored for key, or NOT_FOUND
+int hashMapGet(HashMap, char *);
+// number of keys in the map
+int hashMapSize(HashMap);
+// FNV-1a hash of a string, shared with other hashed structures
+unsigned int hashString(char *);
+
+#endif
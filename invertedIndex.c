@@ -19,27 +19,86 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "readData.h"
+#include "analyser.h"
+#include "termDict.h"
+#include "stats.h"
 #include "set.h"
 #include "BSTree.h"
 #include "mystring.h"
 
+#define TRUE        1
+#define FALSE       0
+#define STEM_FLAG   "--stem"
+#define STOP_FLAG   "--stop"
+#define INDEX_FILE  "invertedIndex.txt"
+
+// percentage by which analysis shrank a count
+static double reduction(int raw, int analysed)
+{
+    return raw == 0 ? 0 : 100.0 * (raw - analysed) / raw;
+}
+
 
 int main(int argc, char **argv) 
 {
+    // --stem and --stop[=FILE] turn on analysis; the search tools pick
+    // the same settings up from ANALYSIS_FILE
+    statsInit(&argc, argv);
+    int stem = FALSE, i;
+    char *stopFile = NULL;
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], STEM_FLAG, strlen(STEM_FLAG)) == 0) {
+            stem = TRUE;
+        } else if (strncmp(argv[i], STOP_FLAG, strlen(STOP_FLAG)) == 0) {
+            char *file = strchr(argv[i], '=');
+            stopFile = file != NULL ? file + 1 : DEFAULT_STOP;
+        } else {
+            fprintf(stderr, "Usage: ./invertedIndex [%s] [%s[=FILE]] [%s]\n",
+                    STEM_FLAG, STOP_FLAG, STATS_FLAG);
+            exit(EXIT_FAILURE);
+        }
+    }
+    Analyser analyser = NULL;
+    if (stem || stopFile != NULL) {
+        analyser = newAnalyser(stem, stopFile);
+        saveAnalyser(analyser);
+    } else {
+        clearAnalyser();
+    }
+
     // get Set of URLs
+    double start = statsClock();
     Set URLSet = getCollection();
-    /* Creates a list of url for each word found in urls. */
+    statsTime("load", start);
     // Create a list of urls for each word found in URL
-    BSTree invList = getInvertedList(URLSet);
+    // the counts are only printed, so only kept, when analysing
+    IndexStats stats;
+    start = statsClock();
+    BSTree invList = getInvertedList(URLSet, analyser, analyser != NULL ? &stats : NULL);
+    statsTime("index", start);
+    if (analyser != NULL) {
+        fprintf(stderr, "terms %d -> %d (-%.1f%%), postings %d -> %d (-%.1f%%)\n",
+                stats.rawTerms, stats.terms, reduction(stats.rawTerms, stats.terms),
+                stats.rawPostings, stats.postings,
+                reduction(stats.rawPostings, stats.postings));
+    }
 
     // print to file
-    FILE *invtxt = fopen("invertedIndex.txt", "w");
+    start = statsClock();
+    FILE *invtxt = fopen(INDEX_FILE, "w");
     BSTreeInfix(invtxt, invList);
     fclose(invtxt);
+    statsTime("write", start);
+    // perfect hash of the words so searches can go straight to their line
+    start = statsClock();
+    buildTermDict(INDEX_FILE, DICT_FILE);
+    statsTime("dictionary", start);
     // free memory
     disposeSet(URLSet);
     dropBSTree(invList);
+    freeAnalyser(analyser);
 
     return 0;
 }
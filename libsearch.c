@@ -0,0 +1,674 @@
+/* libsearch.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * Everything is held by URL ID:
+ *  - the collection keeps the URL names, a HashMap from name to ID and,
+ *    once the pages have been parsed, their links in CSR form (the links
+ *    of ID v are linkDst[linkStart[v] .. linkStart[v+1]-1]).
+ *  - the index maps each word to a term number with a HashMap; term t is
+ *    the word termWords[t] and has a posting list of the IDs containing
+ *    it, ascending, with the number of times it occurs in each (counted
+ *    from the pages when a loaded index is read).
+ *  - the ranker keeps rank and out-degree by ID, and the IDs in the order
+ *    pagerankList.txt lists them.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "libsearch.h"
+#include "readData.h"
+#include "mystring.h"
+#include "hashMap.h"
+#include "tokeniser.h"
+#include "analyser.h"
+#include "linkGraph.h"
+#include "rankTable.h"
+#include "stats.h"
+
+#define TRUE            1
+#define FALSE           0
+#define COLLECTION_FILE "collection.txt"
+#define INDEX_FILE      "invertedIndex.txt"
+#define PAGERANK_FILE   "pagerankList.txt"
+#define PAGE_SUFFIX     ".txt"
+#define UNCOUNTED       -1
+#define INITIAL_CAP     4
+
+typedef struct postingList {
+    int  n, cap;
+    int *ids;
+    int *counts;
+} PostingList;
+
+struct searchCollection {
+    char   *dir;
+    int     nURLs;
+    char  **urls;
+    HashMap ids;
+    long   *linkStart;  // NULL until the pages are parsed
+    int    *linkDst;
+    PageArchive archive;    // the packed pages, NULL if there are none
+};
+
+struct searchIndex {
+    SearchCollection c;
+    Analyser     analyser;
+    HashMap      terms;
+    int          nTerms, capTerms;
+    char       **termWords;     // word of each term number
+    PostingList *postings;
+    int         *pageWords; // words per page (the tf denominator) or UNCOUNTED
+};
+
+struct searchRanker {
+    SearchCollection c;
+    double *rank;
+    int    *outLinks;
+    int    *order;
+    int     nRanked;
+};
+
+typedef struct rankedURL {
+    int    id;
+    int    position;    // tie break: earlier first
+    double score;
+} RankedURL;
+
+
+// dir/name followed by suffix, in a new string
+static char *pathIn(char *dir, char *name, char *suffix)
+{
+    int size = strlen(dir) + strlen(name) + strlen(suffix) + 2;
+    char *path = malloc(size);
+    assert(path != NULL);
+    snprintf(path, size, "%s/%s%s", dir, name, suffix);
+    return path;
+}
+
+
+SearchCollection openCollection(char *dir)
+{
+    char *path = pathIn(dir, COLLECTION_FILE, "");
+    FILE *file = statsFopen(path, "r");
+    free(path);
+    if (file == NULL) return NULL;
+    Set URLList = readCollection(file);
+    fclose(file);
+
+    SearchCollection c = calloc(1, sizeof(struct searchCollection));
+    assert(c != NULL);
+    c->dir = mystrdup(dir);
+    c->nURLs = nElems(URLList);
+    c->urls = malloc((c->nURLs + 1) * sizeof(char *));
+    c->ids = newHashMap(c->nURLs);
+    assert(c->urls != NULL);
+    SetNode curr;
+    int id = 0;
+    for (curr = URLList->elems; curr != NULL; curr = curr->next, id++) {
+        c->urls[id] = mystrdup(curr->val);
+        hashMapPut(c->ids, curr->val, id);
+    }
+    disposeSet(URLList);
+    // mapped for the life of the collection; open it again to see a repack
+    char *archivePath = pathIn(dir, ARCHIVE_FILE, "");
+    path = pathIn(dir, COLLECTION_FILE, "");
+    c->archive = openArchive(archivePath, path);
+    free(archivePath); free(path);
+    return c;
+}
+
+
+void closeCollection(SearchCollection c)
+{
+    if (c == NULL) return;
+    int id;
+    for (id = 0; id < c->nURLs; id++) free(c->urls[id]);
+    free(c->urls);
+    disposeHashMap(c->ids);
+    free(c->linkStart);
+    free(c->linkDst);
+    closeArchive(c->archive);
+    free(c->dir);
+    free(c);
+}
+
+
+int collectionSize(SearchCollection c)
+{
+    return c->nURLs;
+}
+
+
+char *collectionURL(SearchCollection c, int id)
+{
+    return c->urls[id];
+}
+
+
+int collectionId(SearchCollection c, char *url)
+{
+    return hashMapGet(c->ids, url);
+}
+
+
+static SearchIndex newIndex(SearchCollection c, Analyser analyser)
+{
+    SearchIndex index = calloc(1, sizeof(struct searchIndex));
+    assert(index != NULL);
+    index->c = c;
+    index->analyser = analyser;
+    index->terms = newHashMap(c->nURLs);
+    index->capTerms = INITIAL_CAP;
+    index->postings = malloc(index->capTerms * sizeof(PostingList));
+    index->termWords = malloc(index->capTerms * sizeof(char *));
+    index->pageWords = malloc((c->nURLs + 1) * sizeof(int));
+    assert(index->postings != NULL && index->termWords != NULL && index->pageWords != NULL);
+    int id;
+    for (id = 0; id < c->nURLs; id++) index->pageWords[id] = UNCOUNTED;
+    return index;
+}
+
+
+// posting list of word, added if it is new
+static PostingList *termPostings(SearchIndex index, char *word)
+{
+    int t = hashMapGet(index->terms, word);
+    if (t != NOT_FOUND) return &index->postings[t];
+    if (index->nTerms == index->capTerms) {
+        index->capTerms *= 2;
+        index->postings = realloc(index->postings, index->capTerms * sizeof(PostingList));
+        index->termWords = realloc(index->termWords, index->capTerms * sizeof(char *));
+        assert(index->postings != NULL && index->termWords != NULL);
+    }
+    t = index->nTerms++;
+    hashMapPut(index->terms, word, t);
+    index->termWords[t] = mystrdup(word);
+    PostingList *p = &index->postings[t];
+    p->n = 0;
+    p->cap = INITIAL_CAP;
+    p->ids = malloc(p->cap * sizeof(int));
+    p->counts = malloc(p->cap * sizeof(int));
+    assert(p->ids != NULL && p->counts != NULL);
+    return p;
+}
+
+
+// counts one more occurrence in page id; pages must come in ID order
+static void addPosting(PostingList *p, int id, int count)
+{
+    if (p->n > 0 && p->ids[p->n - 1] == id) {
+        if (count != UNCOUNTED) p->counts[p->n - 1] += count;
+        return;
+    }
+    if (p->n == p->cap) {
+        p->cap *= 2;
+        p->ids = realloc(p->ids, p->cap * sizeof(int));
+        p->counts = realloc(p->counts, p->cap * sizeof(int));
+        assert(p->ids != NULL && p->counts != NULL);
+    }
+    p->ids[p->n] = id;
+    p->counts[p->n] = count;
+    p->n++;
+}
+
+
+/* Records the links in urls (section 1 of page id), the way getGraph
+ * does: no links to itself, none twice, and none outside the collection.
+ * lastLinked[v] is the last page that linked to v.
+ */
+static void addLinks(SearchCollection c, int id, char *urls, long *nLinks,
+                     long *capLinks, int *lastLinked)
+{
+    char *next = urls;
+    c->linkStart[id] = *nLinks;
+    while (*next != '\0') {
+        char *name = next;
+        while (*next != '\0' && *next != ' ') next++;
+        if (*next == ' ') *next++ = '\0';
+        if (*name == '\0') continue;
+        int dst = hashMapGet(c->ids, name);
+        if (dst == NOT_FOUND || dst == id || lastLinked[dst] == id) continue;
+        lastLinked[dst] = id;
+        if (*nLinks == *capLinks) {
+            *capLinks *= 2;
+            c->linkDst = realloc(c->linkDst, *capLinks * sizeof(int));
+            assert(c->linkDst != NULL);
+        }
+        c->linkDst[(*nLinks)++] = dst;
+    }
+}
+
+
+// indexes the words of text (section 2 of page id) as getInvertedList does
+static void indexPage(SearchIndex index, TokenBuffer words, int id, char *text)
+{
+    int i, nWords = tokeniseText(words, text);
+    index->pageWords[id] = nWords;
+    for (i = 0; i < nWords; i++) {
+        char *word = words->text + words->start[i];
+        if (words->len[i] == 0) continue;
+        if (analyseWord(index->analyser, word, words->len[i]) == 0) continue;
+        addPosting(termPostings(index, word), id, 1);
+    }
+}
+
+
+/* Reads every page once, recording the links if the collection does not
+ * have them yet and indexing the words into index unless it is NULL.
+ */
+static void parsePages(SearchCollection c, SearchIndex index)
+{
+    int recordLinks = c->linkStart == NULL;
+    if (!recordLinks && index == NULL) return;
+    long nLinks = 0, capLinks = c->nURLs + 1;
+    int *lastLinked = NULL;
+    if (recordLinks) {
+        c->linkStart = malloc((c->nURLs + 1) * sizeof(long));
+        c->linkDst = malloc(capLinks * sizeof(int));
+        lastLinked = malloc((c->nURLs + 1) * sizeof(int));
+        assert(c->linkStart != NULL && c->linkDst != NULL && lastLinked != NULL);
+        memset(lastLinked, -1, (c->nURLs + 1) * sizeof(int));
+    }
+    TokenBuffer words = newTokenBuffer();
+    int id;
+    for (id = 0; id < c->nURLs; id++) {
+        char *path = pathIn(c->dir, c->urls[id], PAGE_SUFFIX);
+        char *urls, *text;
+        if (!readPageSections(c->archive, path, &urls, &text)) {
+            urls = mystrdup("");
+            text = mystrdup("");
+        }
+        if (recordLinks) addLinks(c, id, urls, &nLinks, &capLinks, lastLinked);
+        if (index != NULL) indexPage(index, words, id, text);
+        free(path); free(urls); free(text);
+    }
+    if (recordLinks) c->linkStart[c->nURLs] = nLinks;
+    freeTokenBuffer(words);
+    free(lastLinked);
+}
+
+
+SearchIndex buildIndex(SearchCollection c, int stem, char *stopFile)
+{
+    Analyser analyser = stem || stopFile != NULL ? newAnalyser(stem, stopFile) : NULL;
+    SearchIndex index = newIndex(c, analyser);
+    parsePages(c, index);
+    return index;
+}
+
+
+/* Fills in the counts of a loaded index and the page lengths from one
+ * pass over the pages, counting as calcTf in searchTfIdf does, so that
+ * queries only read the index. A page only counts for the terms whose
+ * posting lists have it.
+ */
+static void countTerms(SearchIndex index)
+{
+    SearchCollection c = index->c;
+    // next[t] is the first posting of term t not before the current page
+    int *next = calloc(index->nTerms + 1, sizeof(int));
+    assert(next != NULL);
+    TokenBuffer words = newTokenBuffer();
+    int id, i, t, k;
+    for (id = 0; id < c->nURLs; id++) {
+        char *path = pathIn(c->dir, c->urls[id], PAGE_SUFFIX);
+        char *urls, *text;
+        if (readPageSections(c->archive, path, &urls, &text)) {
+            int nWords = tokeniseText(words, text);
+            index->pageWords[id] = nWords;
+            for (i = 0; i < nWords; i++) {
+                char *token = words->text + words->start[i];
+                if (analyseWord(index->analyser, token, words->len[i]) == 0) continue;
+                t = hashMapGet(index->terms, token);
+                if (t == NOT_FOUND) continue;
+                PostingList *p = &index->postings[t];
+                while (next[t] < p->n && p->ids[next[t]] < id) next[t]++;
+                if (next[t] == p->n || p->ids[next[t]] != id) continue;
+                if (p->counts[next[t]] == UNCOUNTED) p->counts[next[t]] = 0;
+                p->counts[next[t]]++;
+            }
+            free(urls); free(text);
+        }
+        free(path);
+    }
+    // pages that could not be read have none
+    for (t = 0; t < index->nTerms; t++)
+        for (k = 0; k < index->postings[t].n; k++)
+            if (index->postings[t].counts[k] == UNCOUNTED) index->postings[t].counts[k] = 0;
+    freeTokenBuffer(words);
+    free(next);
+}
+
+
+SearchIndex loadIndex(SearchCollection c)
+{
+    char *path = pathIn(c->dir, INDEX_FILE, "");
+    FILE *file = statsFopen(path, "r");
+    free(path);
+    if (file == NULL) return NULL;
+    path = pathIn(c->dir, ANALYSIS_FILE, "");
+    SearchIndex index = newIndex(c, readAnalyser(path));
+    free(path);
+
+    // each line is the word, two spaces, then its URLs each followed by a space
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t len;
+    while ((len = getline(&line, &size, file)) != -1) {
+        STATS_ADD(STAT_BYTES, len);
+        char *next = line;
+        while (*next != '\0' && *next != ' ' && *next != '\n') next++;
+        if (next == line || *next != ' ') continue;
+        *next++ = '\0';
+        PostingList *p = termPostings(index, line);
+        char *name;
+        while ((name = strsep(&next, " \n")) != NULL) {
+            int id = *name == '\0' ? NOT_FOUND : hashMapGet(c->ids, name);
+            if (id != NOT_FOUND) addPosting(p, id, UNCOUNTED);
+        }
+    }
+    free(line);
+    fclose(file);
+    countTerms(index);
+    return index;
+}
+
+
+void freeIndex(SearchIndex index)
+{
+    if (index == NULL) return;
+    int t;
+    for (t = 0; t < index->nTerms; t++) {
+        free(index->postings[t].ids);
+        free(index->postings[t].counts);
+        free(index->termWords[t]);
+    }
+    free(index->postings);
+    free(index->termWords);
+    free(index->pageWords);
+    disposeHashMap(index->terms);
+    freeAnalyser(index->analyser);
+    free(index);
+}
+
+
+static int cmpString(const void *a, const void *b)
+{
+    return strcmp(*(char **)a, *(char **)b);
+}
+
+
+void writeIndex(SearchIndex index, FILE *out)
+{
+    char **words = malloc((index->nTerms + 1) * sizeof(char *));
+    assert(words != NULL);
+    memcpy(words, index->termWords, index->nTerms * sizeof(char *));
+    // invertedIndex prints its BSTree in order, which is strcmp order
+    qsort(words, index->nTerms, sizeof(char *), cmpString);
+    int i, k;
+    for (i = 0; i < index->nTerms; i++) {
+        PostingList *p = &index->postings[hashMapGet(index->terms, words[i])];
+        fprintf(out, "%s  ", words[i]);
+        for (k = 0; k < p->n; k++) fprintf(out, "%s ", index->c->urls[p->ids[k]]);
+        fprintf(out, "\n");
+    }
+    free(words);
+}
+
+
+// sorts by score descending, then position ascending
+static int cmpRanked(const void *a, const void *b)
+{
+    const RankedURL *x = a, *y = b;
+    if (x->score != y->score) return x->score < y->score ? 1 : -1;
+    return x->position - y->position;
+}
+
+
+// fills ranker->order from ranked, which it sorts
+static void setOrder(SearchRanker ranker, RankedURL *ranked, int n)
+{
+    qsort(ranked, n, sizeof(RankedURL), cmpRanked);
+    ranker->order = malloc((n + 1) * sizeof(int));
+    assert(ranker->order != NULL);
+    int i;
+    for (i = 0; i < n; i++) ranker->order[i] = ranked[i].id;
+    ranker->nRanked = n;
+}
+
+
+static SearchRanker newRanker(SearchCollection c)
+{
+    SearchRanker ranker = calloc(1, sizeof(struct searchRanker));
+    assert(ranker != NULL);
+    ranker->c = c;
+    ranker->rank = calloc(c->nURLs + 1, sizeof(double));
+    ranker->outLinks = calloc(c->nURLs + 1, sizeof(int));
+    assert(ranker->rank != NULL && ranker->outLinks != NULL);
+    return ranker;
+}
+
+
+SearchRanker buildRanker(SearchCollection c, double damp, double diffPR, int maxIterations)
+{
+    parsePages(c, NULL);
+    int n = c->nURLs, id;
+    long e, nLinks = c->linkStart[n];
+    int *src = malloc((nLinks + 1) * sizeof(int));
+    assert(src != NULL);
+    for (id = 0; id < n; id++)
+        for (e = c->linkStart[id]; e < c->linkStart[id + 1]; e++) src[e] = id;
+    LinkGraph g = newLinkGraph(n, nLinks, src, c->linkDst);
+    free(src);
+
+    SearchRanker ranker = newRanker(c);
+    linkGraphSweepPageRank(g, damp, diffPR, maxIterations, ranker->rank, NULL);
+    memcpy(ranker->outLinks, g->outDegree, n * sizeof(int));
+    freeLinkGraph(g);
+
+    // pagerank writes equal ranks in reverse collection order
+    RankedURL *ranked = malloc((n + 1) * sizeof(RankedURL));
+    assert(ranked != NULL);
+    for (id = 0; id < n; id++) {
+        ranked[id].id = id;
+        ranked[id].position = n - id;
+        ranked[id].score = ranker->rank[id];
+    }
+    setOrder(ranker, ranked, n);
+    free(ranked);
+    return ranker;
+}
+
+
+SearchRanker loadRanker(SearchCollection c)
+{
+    char *path = pathIn(c->dir, PAGERANK_FILE, "");
+    FILE *file = statsFopen(path, "r");
+    free(path);
+    if (file == NULL) return NULL;
+    SearchRanker ranker = newRanker(c);
+    RankedURL *ranked = malloc((c->nURLs + 1) * sizeof(RankedURL));
+    assert(ranked != NULL);
+    int n = 0;
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t len;
+    // each line is "URL, out-degree, rank"; URLs may be listed only once
+    while ((len = getline(&line, &size, file)) != -1 && n < c->nURLs) {
+        STATS_ADD(STAT_BYTES, len);
+        char *comma = strchr(line, ',');
+        if (comma == NULL) continue;
+        *comma = '\0';
+        int id = hashMapGet(c->ids, line);
+        if (id == NOT_FOUND) continue;
+        if (sscanf(comma + 1, " %d, %lf", &ranker->outLinks[id], &ranker->rank[id]) != 2) continue;
+        ranked[n].id = id;
+        ranked[n].position = n;
+        ranked[n].score = ranker->rank[id];
+        n++;
+    }
+    free(line);
+    fclose(file);
+    setOrder(ranker, ranked, n);
+    free(ranked);
+    return ranker;
+}
+
+
+void freeRanker(SearchRanker ranker)
+{
+    if (ranker == NULL) return;
+    free(ranker->rank);
+    free(ranker->outLinks);
+    free(ranker->order);
+    free(ranker);
+}
+
+
+void writeRanks(SearchRanker ranker, FILE *out)
+{
+    int i;
+    for (i = 0; i < ranker->nRanked; i++) {
+        int id = ranker->order[i];
+        fprintf(out, "%s, %d, %.7f\n", ranker->c->urls[id], ranker->outLinks[id], ranker->rank[id]);
+    }
+}
+
+
+void writeRankerTable(SearchRanker ranker, char *tableName, char *listName)
+{
+    int n = ranker->nRanked, i;
+    char **names = malloc((n + 1) * sizeof(char *));
+    int *outLinks = malloc((n + 1) * sizeof(int));
+    double *ranks = malloc((n + 1) * sizeof(double));
+    assert(names != NULL && outLinks != NULL && ranks != NULL);
+    for (i = 0; i < n; i++) {
+        int id = ranker->order[i];
+        names[i] = ranker->c->urls[id];
+        outLinks[i] = ranker->outLinks[id];
+        ranks[i] = ranker->rank[id];
+    }
+    writeRankTable(tableName, listName, n, names, outLinks, ranks);
+    free(names); free(outLinks); free(ranks);
+}
+
+
+double rankerRank(SearchRanker ranker, int id)
+{
+    return ranker->rank[id];
+}
+
+
+int rankerOutLinks(SearchRanker ranker, int id)
+{
+    return ranker->outLinks[id];
+}
+
+
+// the query word as it was indexed, in a new string; NULL for a stop word
+static char *queryTerm(SearchIndex index, char *word)
+{
+    if (word[0] == '\0') return NULL;
+    if (index->analyser == NULL) return mystrdup(word);
+    char *term = normalise(word);
+    if (analyseWord(index->analyser, term, strlen(term)) == 0) {
+        free(term);
+        return NULL;
+    }
+    return term;
+}
+
+
+// posting list of the query word, NULL if no page has it
+static PostingList *queryPostings(SearchIndex index, char *word)
+{
+    char *term = queryTerm(index, word);
+    if (term == NULL) return NULL;
+    int t = hashMapGet(index->terms, term);
+    free(term);
+    return t == NOT_FOUND ? NULL : &index->postings[t];
+}
+
+
+int searchByPagerank(SearchIndex index, SearchRanker ranker, char **words, int nWords,
+                     SearchResult *results, int maxResults)
+{
+    int *count = calloc(index->c->nURLs + 1, sizeof(int));
+    assert(count != NULL);
+    int i, k, maxCount = 0;
+    for (i = 0; i < nWords; i++) {
+        PostingList *p = queryPostings(index, words[i]);
+        if (p == NULL) continue;
+        for (k = 0; k < p->n; k++)
+            if (++count[p->ids[k]] > maxCount) maxCount = count[p->ids[k]];
+    }
+    // most query words first, by pagerank within the same number
+    int nResults = 0, c;
+    for (c = maxCount; c > 0 && nResults < maxResults; c--) {
+        for (i = 0; i < ranker->nRanked && nResults < maxResults; i++) {
+            int id = ranker->order[i];
+            if (count[id] != c) continue;
+            results[nResults].id = id;
+            results[nResults].score = ranker->rank[id];
+            nResults++;
+        }
+    }
+    free(count);
+    return nResults;
+}
+
+
+int searchByTfIdf(SearchIndex index, char **words, int nWords,
+                  SearchResult *results, int maxResults)
+{
+    int n = index->c->nURLs;
+    double *score = calloc(n + 1, sizeof(double));
+    char **terms = malloc((nWords + 1) * sizeof(char *));
+    assert(score != NULL && terms != NULL);
+    int i, k, nTerms = 0;
+    for (i = 0; i < nWords; i++) {
+        char *term = queryTerm(index, words[i]);
+        if (term != NULL) terms[nTerms++] = term;
+    }
+    // searchTfIdf sums over its Set of query words, in strcmp order
+    qsort(terms, nTerms, sizeof(char *), cmpString);
+    for (i = 0; i < nTerms; i++) {
+        if (i > 0 && strcmp(terms[i], terms[i - 1]) == 0) continue;
+        int t = hashMapGet(index->terms, terms[i]);
+        if (t == NOT_FOUND) continue;
+        PostingList *p = &index->postings[t];
+        double idf = log10((double)n / p->n);
+        for (k = 0; k < p->n; k++) {
+            int id = p->ids[k];
+            score[id] += (double)p->counts[k] / index->pageWords[id] * idf;
+        }
+    }
+    for (i = 0; i < nTerms; i++) free(terms[i]);
+    free(terms);
+
+    // equal scores come out in reverse collection order, as searchTfIdf prints them
+    RankedURL *ranked = malloc((n + 1) * sizeof(RankedURL));
+    assert(ranked != NULL);
+    int nRanked = 0, id;
+    for (id = 0; id < n; id++) {
+        if (score[id] == 0) continue;
+        ranked[nRanked].id = id;
+        ranked[nRanked].position = n - id;
+        ranked[nRanked].score = score[id];
+        nRanked++;
+    }
+    qsort(ranked, nRanked, sizeof(RankedURL), cmpRanked);
+    for (i = 0; i < nRanked && i < maxResults; i++) {
+        results[i].id = ranked[i].id;
+        results[i].score = ranked[i].score;
+    }
+    free(score);
+    free(ranked);
+    return i;
+}
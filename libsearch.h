@@ -0,0 +1,91 @@
+/* libsearch.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * The search engine as a library (libsearch.a / libsearch.so), so a
+ * program can build or load a collection once and answer any number of
+ * queries in process, instead of running the tools and going through
+ * invertedIndex.txt and pagerankList.txt for every query.
+ *
+ *  SearchCollection  the URLs in DIR/collection.txt. URL IDs are their
+ *                    positions in the order the tools list them (0 ..
+ *                    collectionSize - 1).
+ *  SearchIndex       word -> IDs of the pages containing it.
+ *  SearchRanker      weighted PageRank of every page.
+ *
+ * build* parses the pages in DIR and gives the same index and ranks as
+ * invertedIndex and pagerank (default mode); load* reads the files those
+ * tools wrote in DIR. Building the index records the links as well, so
+ * buildIndex followed by buildRanker reads each page once. Pages come
+ * from DIR/collection.pack when packCollection made one; it is mapped by
+ * openCollection, so reopen the collection to pick up a repack.
+ *
+ * Queries return the URLs searchPagerank and searchTfIdf print, in the
+ * same order. Queries only read the handles, so any number of threads
+ * can query them at once; loadIndex reads the pages once to count the
+ * words tf-idf needs.
+ *
+ *     SearchCollection c = openCollection("data");
+ *     SearchIndex index = loadIndex(c);
+ *     SearchRanker ranker = loadRanker(c);
+ *     SearchResult top[30];
+ *     int i, n = searchByPagerank(index, ranker, words, nWords, top, 30);
+ *     for (i = 0; i < n; i++) printf("%s\n", collectionURL(c, top[i].id));
+ */
+
+#ifndef LIBSEARCH_H
+#define LIBSEARCH_H
+
+#include <stdio.h>
+
+typedef struct searchCollection *SearchCollection;
+typedef struct searchIndex *SearchIndex;
+typedef struct searchRanker *SearchRanker;
+
+typedef struct searchResult {
+    int    id;          // URL ID
+    double score;       // pagerank, or summed tf-idf
+} SearchResult;
+
+// the collection in directory dir, NULL if it has no collection.txt
+SearchCollection openCollection(char *dir);
+// frees the collection; close its indexes and rankers first
+void closeCollection(SearchCollection);
+int collectionSize(SearchCollection);
+char *collectionURL(SearchCollection, int id);
+// ID of the URL name, or -1
+int collectionId(SearchCollection, char *url);
+
+/* Indexes the pages, analysed as invertedIndex --stem / --stop[=FILE]
+ * would (stopFile NULL for none). Pages that cannot be read are empty.
+ */
+SearchIndex buildIndex(SearchCollection, int stem, char *stopFile);
+// the index in DIR/invertedIndex.txt, NULL if there is none
+SearchIndex loadIndex(SearchCollection);
+void freeIndex(SearchIndex);
+// writes the index in the format of invertedIndex.txt
+void writeIndex(SearchIndex, FILE *out);
+
+// PageRank over the links of the pages, parsing them if not done yet
+SearchRanker buildRanker(SearchCollection, double damp, double diffPR, int maxIterations);
+// the ranks in DIR/pagerankList.txt, NULL if there is none
+SearchRanker loadRanker(SearchCollection);
+void freeRanker(SearchRanker);
+// writes the ranks in the format of pagerankList.txt
+void writeRanks(SearchRanker, FILE *out);
+// writes the binary copy of listName, just written by writeRanks (rankTable.h)
+void writeRankerTable(SearchRanker, char *tableName, char *listName);
+double rankerRank(SearchRanker, int id);
+int rankerOutLinks(SearchRanker, int id);
+
+/* Pages containing any of the query words, most words first and then by
+ * pagerank. At most maxResults go into results; returns how many.
+ */
+int searchByPagerank(SearchIndex, SearchRanker, char **words, int nWords,
+                     SearchResult *results, int maxResults);
+// Pages by the sum of tf-idf over the distinct query words, highest first
+int searchByTfIdf(SearchIndex, char **words, int nWords,
+                  SearchResult *results, int maxResults);
+
+#endif
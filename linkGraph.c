@@ -0,0 +1,379 @@
+/* linkGraph.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * REORDERING:
+ * URL IDs normally follow the lexicographic order of the collection,
+ * which says nothing about which pages link to each other, so the
+ * prev[src] gathers in the PageRank loop jump all over the rank vector.
+ *  - REORDER_DEGREE: pages with the most outlinks first, so the entries
+ *    read most often share a few cache lines.
+ *  - REORDER_RCM: reverse Cuthill-McKee over the undirected link graph,
+ *    so linked pages get nearby IDs and each row's gathers stay local.
+ * order[] remembers the original ID of every relabelled URL. Each row
+ * keeps its sources in the original order, and the sweep still visits
+ * the URLs in the original order, so a relabelled graph gives the same
+ * ranks bit for bit; only where they sit in memory changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "graph.h"
+#include "hashMap.h"
+#include "linkGraph.h"
+
+#define NO_OUTLINKS 0.5
+
+typedef struct idKey {
+    int id;
+    int key;
+    int tie;
+} IdKey;
+
+
+// counts per bucket -> start offsets (size n+1)
+static long *prefixSums(int *count, int n)
+{
+    long *start = malloc((n + 1) * sizeof(long));
+    assert(start != NULL);
+    int i;
+    start[0] = 0;
+    for (i = 0; i < n; i++) start[i + 1] = start[i] + count[i];
+    return start;
+}
+
+
+LinkGraph newLinkGraph(int nURLs, long nEdges, int *src, int *dst)
+{
+    LinkGraph g = calloc(1, sizeof(struct linkGraph));
+    assert(g != NULL);
+    g->nURLs = nURLs;
+    g->nEdges = nEdges;
+    g->outDegree = calloc(nURLs, sizeof(int));
+    g->order = malloc(nURLs * sizeof(int));
+    int *inDegree = calloc(nURLs, sizeof(int));
+    double *inSum = calloc(nURLs, sizeof(double));
+    double *outSum = calloc(nURLs, sizeof(double));
+    assert(g->outDegree != NULL && g->order != NULL && inDegree != NULL);
+    assert(inSum != NULL && outSum != NULL);
+    long e;
+    int i;
+    for (i = 0; i < nURLs; i++) g->order[i] = i;
+    for (e = 0; e < nEdges; e++) {
+        g->outDegree[src[e]]++;
+        inDegree[dst[e]]++;
+    }
+    // Denominators of Win and Wout are sums over the source's outlinks.
+    for (e = 0; e < nEdges; e++) {
+        int d = dst[e];
+        inSum[src[e]] += inDegree[d];
+        outSum[src[e]] += g->outDegree[d] == 0 ? NO_OUTLINKS : g->outDegree[d];
+    }
+
+    g->inStart = prefixSums(inDegree, nURLs);
+    g->inSrc = malloc((nEdges + 1) * sizeof(int));
+    g->inWeight = malloc((nEdges + 1) * sizeof(double));
+    long *next = malloc((nURLs + 1) * sizeof(long));
+    assert(g->inSrc != NULL && g->inWeight != NULL && next != NULL);
+    memcpy(next, g->inStart, (nURLs + 1) * sizeof(long));
+    for (e = 0; e < nEdges; e++) {
+        int s = src[e], d = dst[e];
+        double out = g->outDegree[d] == 0 ? NO_OUTLINKS : g->outDegree[d];
+        long pos = next[d]++;
+        g->inSrc[pos] = s;
+        g->inWeight[pos] = (inDegree[d] / inSum[s]) * (out / outSum[s]);
+    }
+    free(next); free(inDegree); free(inSum); free(outSum);
+    return g;
+}
+
+
+LinkGraph graphToLinkGraph(Graph web)
+{
+    int n = web->numURLs;
+    int i;
+    HashMap ids = newHashMap(n);
+    long nEdges = 0;
+    for (i = 0; i < n; i++) {
+        hashMapPut(ids, web->listOfUrls[i]->URLName, i);
+        nEdges += web->listOfUrls[i]->numOutLinks;
+    }
+    int *src = malloc((nEdges + 1) * sizeof(int));
+    int *dst = malloc((nEdges + 1) * sizeof(int));
+    assert(src != NULL && dst != NULL);
+    long e = 0;
+    for (i = 0; i < n; i++) {
+        Link curr = web->listOfUrls[i]->outLink;
+        for (; curr != NULL; curr = curr->next) {
+            int d = hashMapGet(ids, curr->URLName);
+            if (d == NOT_FOUND) continue;
+            src[e] = i; dst[e] = d; e++;
+        }
+    }
+    LinkGraph g = newLinkGraph(n, e, src, dst);
+    free(src); free(dst);
+    disposeHashMap(ids);
+    return g;
+}
+
+
+void freeLinkGraph(LinkGraph g)
+{
+    if (g == NULL) return;
+    free(g->outDegree); free(g->inStart); free(g->inSrc);
+    free(g->inWeight); free(g->order);
+    free(g);
+}
+
+
+/* Builds the out-link lists (transpose of the in-links).
+ * Edge k of the result came from in-link edgeOf[k].
+ */
+long *linkGraphOutLists(LinkGraph g, int **outDst, long **edgeOf)
+{
+    long *outStart = prefixSums(g->outDegree, g->nURLs);
+    long *next = malloc((g->nURLs + 1) * sizeof(long));
+    *outDst = malloc((g->nEdges + 1) * sizeof(int));
+    *edgeOf = malloc((g->nEdges + 1) * sizeof(long));
+    assert(next != NULL && *outDst != NULL && *edgeOf != NULL);
+    memcpy(next, outStart, (g->nURLs + 1) * sizeof(long));
+    int v;
+    long e;
+    for (v = 0; v < g->nURLs; v++) {
+        for (e = g->inStart[v]; e < g->inStart[v + 1]; e++) {
+            long pos = next[g->inSrc[e]]++;
+            (*outDst)[pos] = v;
+            (*edgeOf)[pos] = e;
+        }
+    }
+    free(next);
+    return outStart;
+}
+
+
+// sorts by key descending, then tie descending, then ID
+static int cmpIdKey(const void *a, const void *b)
+{
+    const IdKey *x = a, *y = b;
+    if (x->key != y->key) return y->key - x->key;
+    if (x->tie != y->tie) return y->tie - x->tie;
+    return x->id - y->id;
+}
+
+
+/* Most outlinks first: the most gathered ranks end up adjacent. */
+static void degreeOrder(LinkGraph g, int *perm)
+{
+    IdKey *keys = malloc(g->nURLs * sizeof(IdKey));
+    assert(keys != NULL);
+    int v;
+    for (v = 0; v < g->nURLs; v++) {
+        keys[v].id = v;
+        keys[v].key = g->outDegree[v];
+        keys[v].tie = g->inStart[v + 1] - g->inStart[v];
+    }
+    qsort(keys, g->nURLs, sizeof(IdKey), cmpIdKey);
+    for (v = 0; v < g->nURLs; v++) perm[v] = keys[v].id;
+    free(keys);
+}
+
+
+/* Reverse Cuthill-McKee: BFS from a low degree page, visiting
+ * neighbours (in or out links) in increasing degree, then reversed.
+ */
+static void rcmOrder(LinkGraph g, int *perm)
+{
+    int n = g->nURLs;
+    int *outDst; long *edgeOf;
+    long *outStart = linkGraphOutLists(g, &outDst, &edgeOf);
+    free(edgeOf);
+    int *degree = malloc(n * sizeof(int));
+    char *visited = calloc(n, sizeof(char));
+    IdKey *byDegree = malloc(n * sizeof(IdKey));
+    IdKey *nbrs = malloc(n * sizeof(IdKey));
+    assert(degree != NULL && visited != NULL && byDegree != NULL && nbrs != NULL);
+    int v;
+    for (v = 0; v < n; v++) {
+        degree[v] = g->outDegree[v] + (int)(g->inStart[v + 1] - g->inStart[v]);
+        // negated so cmpIdKey gives ascending degree
+        byDegree[v].id = v; byDegree[v].key = -degree[v]; byDegree[v].tie = 0;
+    }
+    qsort(byDegree, n, sizeof(IdKey), cmpIdKey);
+
+    int head = 0, tail = 0, s;
+    long e;
+    for (s = 0; s < n; s++) {
+        int start = byDegree[s].id;
+        if (visited[start]) continue;
+        visited[start] = 1;
+        perm[tail++] = start;
+        // perm doubles as the BFS queue
+        while (head < tail) {
+            int u = perm[head++], k = 0;
+            for (e = g->inStart[u]; e < g->inStart[u + 1]; e++) {
+                int w = g->inSrc[e];
+                if (visited[w]) continue;
+                visited[w] = 1;
+                nbrs[k].id = w; nbrs[k].key = -degree[w]; nbrs[k].tie = 0; k++;
+            }
+            for (e = outStart[u]; e < outStart[u + 1]; e++) {
+                int w = outDst[e];
+                if (visited[w]) continue;
+                visited[w] = 1;
+                nbrs[k].id = w; nbrs[k].key = -degree[w]; nbrs[k].tie = 0; k++;
+            }
+            qsort(nbrs, k, sizeof(IdKey), cmpIdKey);
+            int i;
+            for (i = 0; i < k; i++) perm[tail++] = nbrs[i].id;
+        }
+    }
+    // reverse
+    for (v = 0; v < n / 2; v++) {
+        int tmp = perm[v]; perm[v] = perm[n - 1 - v]; perm[n - 1 - v] = tmp;
+    }
+    free(outStart); free(outDst); free(degree); free(visited);
+    free(byDegree); free(nbrs);
+}
+
+
+/* Applies perm (perm[new] = old) to every array of the graph.
+ * Rows are rebuilt through the out-lists with the sources in their
+ * original order, so every in-link sum adds up in the same order.
+ */
+static void relabel(LinkGraph g, int *perm)
+{
+    int n = g->nURLs;
+    int *newId = malloc(n * sizeof(int));
+    int *inDegree = malloc(n * sizeof(int));
+    int *outDegree = malloc(n * sizeof(int));
+    int *order = malloc(n * sizeof(int));
+    assert(newId != NULL && inDegree != NULL && outDegree != NULL && order != NULL);
+    int v;
+    for (v = 0; v < n; v++) {
+        int old = perm[v];
+        newId[old] = v;
+        inDegree[v] = g->inStart[old + 1] - g->inStart[old];
+        outDegree[v] = g->outDegree[old];
+        order[v] = g->order[old];
+    }
+    int *outDst; long *edgeOf;
+    long *outStart = linkGraphOutLists(g, &outDst, &edgeOf);
+    long *inStart = prefixSums(inDegree, n);
+    long *next = malloc((n + 1) * sizeof(long));
+    int *inSrc = malloc((g->nEdges + 1) * sizeof(int));
+    double *inWeight = malloc((g->nEdges + 1) * sizeof(double));
+    assert(next != NULL && inSrc != NULL && inWeight != NULL);
+    memcpy(next, inStart, (n + 1) * sizeof(long));
+    long e;
+    // sources visited in original ID order, so rows keep the order of
+    // the graph before any relabelling
+    int *byOriginal = malloc(n * sizeof(int));
+    assert(byOriginal != NULL);
+    for (v = 0; v < n; v++) byOriginal[g->order[v]] = v;
+    int k;
+    for (k = 0; k < n; k++) {
+        int old = byOriginal[k];
+        for (e = outStart[old]; e < outStart[old + 1]; e++) {
+            long pos = next[newId[outDst[e]]]++;
+            inSrc[pos] = newId[old];
+            inWeight[pos] = g->inWeight[edgeOf[e]];
+        }
+    }
+    free(g->outDegree); free(g->inStart); free(g->inSrc);
+    free(g->inWeight); free(g->order);
+    g->outDegree = outDegree; g->inStart = inStart; g->inSrc = inSrc;
+    g->inWeight = inWeight; g->order = order;
+    free(newId); free(inDegree); free(outStart); free(outDst);
+    free(edgeOf); free(next); free(byOriginal);
+}
+
+
+void reorderLinkGraph(LinkGraph g, int method)
+{
+    if (method == REORDER_NONE || g->nURLs == 0) return;
+    int *perm = malloc(g->nURLs * sizeof(int));
+    assert(perm != NULL);
+    if (method == REORDER_DEGREE) degreeOrder(g, perm);
+    else rcmOrder(g, perm);
+    relabel(g, perm);
+    free(perm);
+}
+
+
+int linkGraphPageRank(LinkGraph g, double damp, double diffPR, int maxIterations,
+                      double *ranks, PRTrace trace)
+{
+    int n = g->nURLs;
+    double *prev = ranks;
+    double *curr = malloc((n + 1) * sizeof(double));
+    assert(curr != NULL);
+    int v;
+    long e;
+    for (v = 0; v < n; v++) prev[v] = 1.0/n;
+
+    int iter = 0;
+    double diff = diffPR;
+    traceStartIterations(trace);
+    while (iter < maxIterations && diff >= diffPR) {
+        diff = 0;
+        for (v = 0; v < n; v++) {
+            double sum = 0;
+            for (e = g->inStart[v]; e < g->inStart[v + 1]; e++)
+                sum += prev[g->inSrc[e]] * g->inWeight[e];
+            curr[v] = (1 - damp)/n + damp * sum;
+            diff += fabs(curr[v] - prev[v]);
+        }
+        double *tmp = prev; prev = curr; curr = tmp;
+        traceIteration(trace, diff, g->nEdges);
+        iter++;
+    }
+    // final ranks must end up in the caller's array
+    if (prev != ranks) {
+        memcpy(ranks, prev, n * sizeof(double));
+        curr = prev;
+    }
+    free(curr);
+    return iter;
+}
+
+
+int linkGraphSweepPageRank(LinkGraph g, double damp, double diffPR, int maxIterations,
+                           double *ranks, PRTrace trace)
+{
+    int n = g->nURLs;
+    int v, k;
+    long e;
+    // a relabelled graph is still swept in the original ID order
+    int *byOriginal = malloc((n + 1) * sizeof(int));
+    assert(byOriginal != NULL);
+    for (v = 0; v < n; v++) {
+        ranks[v] = 1.0/n;
+        byOriginal[g->order[v]] = v;
+    }
+
+    int iter = 0;
+    double diff = diffPR;
+    traceStartIterations(trace);
+    while (iter < maxIterations && diff >= diffPR) {
+        double residual = 0;
+        for (k = 0; k < n; k++) {
+            v = byOriginal[k];
+            double sum = 0;
+            for (e = g->inStart[v]; e < g->inStart[v + 1]; e++)
+                sum += ranks[g->inSrc[e]] * g->inWeight[e];
+            double curr = (1 - damp)/n + damp * sum;
+            // as calculateDiffPR: the change of this URL, added up n times
+            diff = n * fabs(curr - ranks[v]);
+            residual += fabs(curr - ranks[v]);
+            ranks[v] = curr;
+        }
+        traceIteration(trace, residual, g->nEdges);
+        iter++;
+    }
+    free(byOriginal);
+    return iter;
+}
@@ -0,0 +1,54 @@
+/* linkGraph.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Compressed (CSR) in-link graph with precomputed Win * Wout weights.
+ * URLs are identified by dense IDs so the PageRank inner loop is a
+ * gather over an int array instead of a walk over linked lists.
+ */
+
+#include "graph.h"
+#include "prTrace.h"
+
+#ifndef LINKGRAPH_H
+#define LINKGRAPH_H
+
+#define REORDER_NONE    0
+#define REORDER_DEGREE  1
+#define REORDER_RCM     2
+
+typedef struct linkGraph *LinkGraph;
+
+struct linkGraph {
+    int     nURLs;
+    long    nEdges;
+    int    *outDegree;  // by ID
+    long   *inStart;    // in-links of v are inSrc[inStart[v] .. inStart[v+1]-1]
+    int    *inSrc;
+    double *inWeight;
+    int    *order;      // order[v] is the original ID of v
+};
+
+// builds a link graph from parallel src/dst arrays of nEdges distinct links
+LinkGraph newLinkGraph(int nURLs, long nEdges, int *src, int *dst);
+// builds a link graph with IDs matching web->listOfUrls
+LinkGraph graphToLinkGraph(Graph web);
+// free memory associated with the link graph
+void freeLinkGraph(LinkGraph);
+// out-links of v are outDst[start[v] .. start[v+1]-1]; returns start
+long *linkGraphOutLists(LinkGraph, int **outDst, long **edgeOf);
+// relabels the IDs for locality (REORDER_DEGREE or REORDER_RCM)
+void reorderLinkGraph(LinkGraph, int method);
+// weighted PageRank; ranks (indexed by ID) receives the result
+int linkGraphPageRank(LinkGraph, double damp, double diffPR, int maxIterations,
+                      double *ranks, PRTrace trace);
+/* weighted PageRank with the updates of PageRankW in pagerank.c: each
+ * rank is overwritten as soon as it is computed, in the original ID
+ * order (order[]) even after reorderLinkGraph, and the loop stops on the
+ * change of the last URL times nURLs
+ */
+int linkGraphSweepPageRank(LinkGraph, double damp, double diffPR, int maxIterations,
+                           double *ranks, PRTrace trace);
+
+#endif
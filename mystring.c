@@ -9,11 +9,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "stats.h"
 
 char *mystrdup(char *word) 
 {
     int len = strlen(word) + 1;
     char *dup = malloc(len);
+    STATS_ADD(STAT_ALLOCS, 1);
     strcpy(dup, word);
     return dup;
 }
@@ -0,0 +1,43 @@
+/* packCollection.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Packs the pages listed in collection.txt into one archive,
+ * collection.pack (see pageArchive.h), which every tool then reads the
+ * pages from instead of opening each url*.txt. The archive is ignored
+ * once collection.txt changes, but the tools do not look at the page
+ * files, so run it again after editing a page. With --watch every page
+ * read checks its file instead and reads a changed page from the file,
+ * at the cost of one stat per page.
+ *
+ * Usage: ./packCollection [--watch] [--stats]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "readData.h"
+#include "pageArchive.h"
+#include "stats.h"
+#include "set.h"
+
+#define COLLECTION_FILE "collection.txt"
+#define WATCH_FLAG      "--watch"
+
+
+int main(int argc, char **argv)
+{
+    statsInit(&argc, argv);
+    int watch = argc == 2 && strcmp(argv[1], WATCH_FLAG) == 0;
+    if (argc != 1 && !watch) {
+        printf("Usage: ./packCollection [%s] [%s]\n", WATCH_FLAG, STATS_FLAG);
+        exit(EXIT_FAILURE);
+    }
+    double start = statsClock();
+    Set URLList = getCollection();
+    packArchive(URLList, ARCHIVE_FILE, COLLECTION_FILE, watch);
+    statsTime("pack", start);
+    disposeSet(URLList);
+    return 0;
+}
@@ -0,0 +1,252 @@
+/* pageArchive.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * FILE LAYOUT:
+ *  ArchiveHeader
+ *  ArchiveEntry entry[nURLs]   by ID
+ *  int          slot[nSlots]   open addressing on hashString(name), linear
+ *                              probing; ID or -1
+ *  char         names[namesSize]   the URLs, each NUL-terminated
+ *  char         data[dataSize]     page i is data[offset .. offset+length-1]
+ * nSlots is a power of two at least twice nURLs. The header keeps the
+ * size and modification time (ns) of collection.txt and whether the
+ * pages are watched; each entry keeps the modification time its page
+ * had when it was packed (its size is the length).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pageArchive.h"
+#include "hashMap.h"
+#include "stats.h"
+#include "fileUtil.h"
+
+#define TRUE        1
+#define FALSE       0
+#define EMPTY       -1
+#define MAX_NAME    1024
+#define COPY_SIZE   65536
+
+typedef struct archiveHeader {
+    int  magic;
+    int  nURLs;
+    int  nSlots;
+    int  flags;         // ARCHIVE_WATCH
+    long namesSize;
+    long dataSize;
+    long collectionSize;    // version of collection.txt when packed
+    long collectionTime;
+} ArchiveHeader;
+
+typedef struct archiveEntry {
+    long offset;        // in data
+    long length;
+    long time;          // modification time of the page when packed
+    int  name;          // offset in names
+    int  unused;
+} ArchiveEntry;
+
+struct pageArchive {
+    ArchiveHeader *header;
+    ArchiveEntry  *entry;
+    int           *slot;
+    char          *names;
+    char          *data;
+    long           mapSize;
+};
+
+
+static void pageFileName(char *URLName, char *fileName)
+{
+    snprintf(fileName, MAX_NAME, "%s.txt", URLName);
+}
+
+
+/* Appends the file URLName.txt to out, returning its length; *time is
+ * its modification time before the copy.
+ */
+static long copyPage(char *URLName, FILE *out, long *time)
+{
+    char fileName[MAX_NAME], buffer[COPY_SIZE];
+    pageFileName(URLName, fileName);
+    long size;
+    fileVersion(fileName, &size, time);
+    FILE *page = fopen(fileName, "rb");
+    if (page == NULL) return 0;
+    long length = 0;
+    size_t n;
+    while ((n = fread(buffer, 1, COPY_SIZE, page)) > 0) {
+        fwrite(buffer, 1, n, out);
+        length += n;
+    }
+    fclose(page);
+    return length;
+}
+
+
+void packArchive(Set URLList, char *fileName, char *collectionName, int watchPages)
+{
+    int n = nElems(URLList), i;
+    ArchiveHeader h = { ARCHIVE_MAGIC, n, 1, watchPages ? ARCHIVE_WATCH : 0, 0, 0, 0, 0 };
+    if (!fileVersion(collectionName, &h.collectionSize, &h.collectionTime)) {
+        perror("stat failed");
+        exit(EXIT_FAILURE);
+    }
+    while (h.nSlots < 2 * n) h.nSlots *= 2;
+    ArchiveEntry *entry = calloc(n + 1, sizeof(ArchiveEntry));
+    int *slot = malloc(h.nSlots * sizeof(int));
+    assert(entry != NULL && slot != NULL);
+    memset(slot, EMPTY, h.nSlots * sizeof(int));
+    SetNode curr;
+    char pageName[MAX_NAME];
+    struct stat st;
+    for (curr = URLList->elems, i = 0; curr != NULL; curr = curr->next, i++) {
+        entry[i].name = h.namesSize;
+        h.namesSize += strlen(curr->val) + 1;
+        // a missing page is left out of the hash table, so it is still
+        // looked for as a file
+        pageFileName(curr->val, pageName);
+        if (stat(pageName, &st) != 0) continue;
+        unsigned int s = hashString(curr->val) & (h.nSlots - 1);
+        while (slot[s] != EMPTY) s = (s + 1) & (h.nSlots - 1);
+        slot[s] = i;
+    }
+
+    // written under another name and renamed, so readers never map half
+    char tmpName[MAX_NAME];
+    FILE *file = openTemp(fileName, tmpName, MAX_NAME);
+    // the header and entries are written again once the lengths are known
+    fwrite(&h, sizeof(ArchiveHeader), 1, file);
+    fwrite(entry, sizeof(ArchiveEntry), n, file);
+    fwrite(slot, sizeof(int), h.nSlots, file);
+    for (curr = URLList->elems; curr != NULL; curr = curr->next)
+        fwrite(curr->val, 1, strlen(curr->val) + 1, file);
+    for (curr = URLList->elems, i = 0; curr != NULL; curr = curr->next, i++) {
+        entry[i].offset = h.dataSize;
+        entry[i].length = copyPage(curr->val, file, &entry[i].time);
+        h.dataSize += entry[i].length;
+    }
+    rewind(file);
+    fwrite(&h, sizeof(ArchiveHeader), 1, file);
+    fwrite(entry, sizeof(ArchiveEntry), n, file);
+    if (!commitTemp(file, tmpName, fileName)) { perror("rename failed"); exit(EXIT_FAILURE); }
+    free(entry); free(slot);
+}
+
+
+PageArchive openArchive(char *fileName, char *collectionName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+    STATS_ADD(STAT_FILES, 1);
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= sizeof(ArchiveHeader))
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    ArchiveHeader *h = map;
+    long size, time;
+    int valid = h->magic == ARCHIVE_MAGIC && h->nURLs >= 0 && h->nSlots > 0
+             && (h->nSlots & (h->nSlots - 1)) == 0
+             && h->namesSize >= 0 && h->dataSize >= 0
+             && sizeof(ArchiveHeader) + h->nURLs * sizeof(ArchiveEntry)
+                + h->nSlots * sizeof(int) + h->namesSize + h->dataSize == st.st_size
+             && fileVersion(collectionName, &size, &time)
+             && size == h->collectionSize && time == h->collectionTime;
+    PageArchive archive = NULL;
+    if (valid) {
+        archive = malloc(sizeof(struct pageArchive));
+        assert(archive != NULL);
+        archive->header = h;
+        archive->entry = (ArchiveEntry *)(h + 1);
+        archive->slot = (int *)(archive->entry + h->nURLs);
+        archive->names = (char *)(archive->slot + h->nSlots);
+        archive->data = archive->names + h->namesSize;
+        archive->mapSize = st.st_size;
+        // the table is small next to the pages; check it once here
+        int i;
+        for (i = 0; i < h->nURLs && valid; i++) {
+            ArchiveEntry *e = &archive->entry[i];
+            valid = e->name >= 0 && e->name < h->namesSize
+                 && e->offset >= 0 && e->length >= 0
+                 && e->offset + e->length <= h->dataSize;
+        }
+        for (i = 0; i < h->nSlots && valid; i++)
+            valid = archive->slot[i] >= EMPTY && archive->slot[i] < h->nURLs;
+        valid = valid && (h->namesSize == 0 || archive->names[h->namesSize - 1] == '\0');
+    }
+    if (!valid) {
+        free(archive);
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    return archive;
+}
+
+
+void closeArchive(PageArchive archive)
+{
+    if (archive == NULL) return;
+    munmap(archive->header, archive->mapSize);
+    free(archive);
+}
+
+
+int archiveSize(PageArchive archive)
+{
+    return archive->header->nURLs;
+}
+
+
+int archiveFind(PageArchive archive, char *URLName)
+{
+    int mask = archive->header->nSlots - 1, probes;
+    unsigned int s = hashString(URLName) & mask;
+    for (probes = 0; probes <= mask && archive->slot[s] != EMPTY; probes++, s = (s + 1) & mask) {
+        int id = archive->slot[s];
+        if (STATS_STRCMP(archive->names + archive->entry[id].name, URLName) == 0) return id;
+    }
+    return EMPTY;
+}
+
+
+char *archiveURL(PageArchive archive, int id)
+{
+    return archive->names + archive->entry[id].name;
+}
+
+
+void archivePageVersion(PageArchive archive, int id, long *size, long *time)
+{
+    *size = archive->entry[id].length;
+    *time = archive->entry[id].time;
+}
+
+
+int archivePageCurrent(PageArchive archive, int id, char *pageName)
+{
+    if (!(archive->header->flags & ARCHIVE_WATCH)) return TRUE;
+    long size, time;
+    if (!fileVersion(pageName, &size, &time)) return TRUE;
+    return size == archive->entry[id].length && time == archive->entry[id].time;
+}
+
+
+FILE *archivePage(PageArchive archive, int id)
+{
+    ArchiveEntry *e = &archive->entry[id];
+    // fmemopen may refuse an empty buffer; a lone newline reads as no lines
+    if (e->length == 0) return fmemopen("\n", 1, "r");
+    return fmemopen(archive->data + e->offset, e->length, "r");
+}
@@ -0,0 +1,53 @@
+/* pageArchive.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * A collection's pages packed into one file, ARCHIVE_FILE, next to
+ * collection.txt: a table of (offset, length) by URL ID, a hash table
+ * from URL name to ID, and the page files' bytes one after another in
+ * ID order. readData reads pages from the archive when their directory
+ * has one, so reading the collection is one mmap instead of opening
+ * every url*.txt. The archive is dropped once collection.txt changes,
+ * which is checked once when it is opened. Pages are read from it
+ * without looking at their files, so edit a page and pack again; an
+ * archive packed with watchPages instead checks each page's file (one
+ * stat per read) and reads a page that has changed since from the file.
+ * A page whose file is gone is always read from the archive.
+ */
+
+#include <stdio.h>
+#include "set.h"
+
+#ifndef PAGEARCHIVE_H
+#define PAGEARCHIVE_H
+
+#define ARCHIVE_MAGIC   0x32415043  // "CPA2"
+#define ARCHIVE_FILE    "collection.pack"
+#define ARCHIVE_WATCH   1           // header flag: check the page files
+
+typedef struct pageArchive *PageArchive;
+
+/* Packs the page file URL.txt of every URL in URLList (IDs are positions
+ * in the Set, read from collectionName) into fileName. Missing pages are
+ * not packed. With watchPages the readers check each page's file.
+ */
+void packArchive(Set URLList, char *fileName, char *collectionName, int watchPages);
+// maps fileName, NULL if it is missing, not an archive, or collectionName
+// has changed since it was packed
+PageArchive openArchive(char *fileName, char *collectionName);
+void closeArchive(PageArchive);
+int archiveSize(PageArchive);
+// ID of URLName, or -1
+int archiveFind(PageArchive, char *URLName);
+char *archiveURL(PageArchive, int id);
+// size and modification time the page of the given ID had when packed
+void archivePageVersion(PageArchive, int id, long *size, long *time);
+/* FALSE if the archive was packed with watchPages and the file pageName
+ * of the given ID has changed since; TRUE without a stat otherwise
+ */
+int archivePageCurrent(PageArchive, int id, char *pageName);
+// a read-only stream over the page of the given ID, fclose it after
+FILE *archivePage(PageArchive, int id);
+
+#endif
@@ -16,6 +16,32 @@
  * 
  * FORMAT OF pagerankList.txt:
  *  URL, num of outgoing links, page rank
+ *
+ * OPTIONS (after the required args):
+ *  --stream[=MB]  build an on-disk edge file and iterate by scanning it,
+ *                 keeping at most MB of edges in memory while sorting.
+ *  --reorder=M    iterate over a compact in-link array after relabelling
+ *                 URL IDs for locality (M is none, degree or rcm).
+ *  --scc[=T]      solve one strongly connected component at a time in
+ *                 topological order, independent components on T threads.
+ *                 Each component is iterated to its share of diffPR, so
+ *                 the ranks are within diffPR of the converged PageRank.
+ *                 The default mode stops on the change of the last URL,
+ *                 often after a few sweeps, so the two only agree when
+ *                 both run to convergence (e.g. diffPR 0).
+ *  --shards=N     split the URL IDs across N worker processes that swap
+ *                 ranks through shared memory every iteration. The
+ *                 graph goes through the edge file of --stream, which
+ *                 sets its memory, and each worker reads only its share.
+ *  --trace[=FILE] write per-iteration residual, time and edges/sec plus
+ *                 phase timings as JSON (CSV if FILE ends in .csv);
+ *                 without FILE the trace goes to stderr.
+ *  --snapshot     take the link graph from pagerankGraph.bin instead of
+ *                 parsing the pages, saving it first if it is missing or
+ *                 any page has changed. The default mode then iterates
+ *                 over the compact graph with the same updates.
+ *
+ * pagerankList.bin gets the same list in binary for searchPagerank.
  */
 
 #include <stdio.h>
@@ -24,6 +50,14 @@
 #include "graph.h"
 #include "readData.h"
 #include "mystring.h"
+#include "edgeFile.h"
+#include "linkGraph.h"
+#include "prTrace.h"
+#include "stats.h"
+#include "blockRank.h"
+#include "shardRank.h"
+#include "graphSnapshot.h"
+#include "rankTable.h"
 #include <string.h>
 #include <math.h>
 #include <assert.h>
@@ -38,6 +72,13 @@
 #define MAX_ITER 3
 #define TRUE 1
 #define FALSE 0
+#define STREAM_FLAG "--stream"
+#define EDGE_FILE "pagerankEdges.bin"
+#define REORDER_FLAG "--reorder="
+#define TRACE_FLAG "--trace"
+#define SCC_FLAG "--scc"
+#define SHARDS_FLAG "--shards="
+#define SNAPSHOT_FLAG "--snapshot"
 
 typedef struct pageRankNode *PRNode;
 
@@ -136,10 +177,11 @@ PRNode newPageRankNode(char *URLName, int nURLs) {
 
 
 /* Calculates pageranks of all URLs by DFS traversal. */
-PRNode *PageRankW(Set URLList, double damp, double diffPR, int maxIterations, Graph web)  
+PRNode *PageRankW(Set URLList, double damp, double diffPR, int maxIterations, Graph web, PRTrace trace)  
 {
     int i, j; // Generic counters.
     int nURLs = nElems(URLList);
+    long nEdges = 0;
     // Make a before and current PR array.
     PRNode *urlPRs = malloc(nURLs * sizeof(URL));
 
@@ -149,26 +191,154 @@ PRNode *PageRankW(Set URLList, double damp, double diffPR, int maxIterations, Gr
         urlPRs[i] = newPageRankNode(currLink->val, nURLs);
         urlPRs[i]->nOutLinks = web->listOfUrls[i]->numOutLinks;
         urlPRs[i]->nInlinks = web->listOfUrls[i]->numInLinks;
+        nEdges += urlPRs[i]->nInlinks;
         currLink = currLink->next;
     }
+    traceGraph(trace, nURLs, nEdges);
 
     i = 0;
     double diff = diffPR;
     // While less than max iterations or difference is not small enough.
     
+    traceStartIterations(trace);
     while (i < maxIterations && diff >= diffPR) {
+        double residual = 0;
         // For each URL, calculate the new pagerank.
         for (j = 0; j < web->numURLs; j++) {
             urlPRs[j]->currPR = calculateCurrPR(urlPRs[j], urlPRs, web, damp, nURLs);
             diff = calculateDiffPR(urlPRs[j], web);
+            residual += fabs(urlPRs[j]->currPR - urlPRs[j]->prevPR);
             urlPRs[j]->prevPR = urlPRs[j]->currPR;
         }
+        traceIteration(trace, residual, nEdges);
         i++;
     }
     return urlPRs;
 }
 
 
+/* Calculates pageranks by streaming the link graph from disk, or with
+ * nShards > 0 by worker processes each loading a slice of it.
+ */
+PRNode *streamPageRankW(Set URLList, double damp, double diffPR, int maxIterations,
+                        int memMB, int nShards, PRTrace trace)
+{
+    int i;
+    int nURLs = nElems(URLList);
+    int *outDegree = malloc(nURLs * sizeof(int));
+    double *ranks = malloc(nURLs * sizeof(double));
+    assert(outDegree != NULL && ranks != NULL);
+    double start = traceClock();
+    long nEdges = buildEdgeFile(URLList, EDGE_FILE, outDegree, memMB);
+    tracePhase(trace, "graph", traceClock() - start);
+    traceGraph(trace, nURLs, nEdges);
+    start = traceClock();
+    if (nShards > 0)
+        shardPageRank(EDGE_FILE, damp, diffPR, maxIterations, nShards, ranks, trace);
+    else
+        streamPageRank(EDGE_FILE, damp, diffPR, maxIterations, ranks, trace);
+    tracePhase(trace, "iterate", traceClock() - start);
+    remove(EDGE_FILE);
+
+    PRNode *urlPRs = malloc(nURLs * sizeof(PRNode));
+    SetNode currLink = URLList->elems;
+    for (i = 0; i < nURLs; i++) {
+        urlPRs[i] = newPageRankNode(currLink->val, nURLs);
+        urlPRs[i]->nOutLinks = outDegree[i];
+        urlPRs[i]->currPR = ranks[i];
+        currLink = currLink->next;
+    }
+    free(outDegree); free(ranks);
+    return urlPRs;
+}
+
+
+/* Calculates pageranks over a relabelled compact copy of the graph and
+ * maps the results back to URL names; names and outLinks are by the
+ * original IDs. The ranks are updated in place in the original ID order
+ * like PageRankW, so the relabelling (method, or INVALID_VAL for none)
+ * changes only the memory layout and not the output. With sccThreads > 0
+ * the graph is solved component by component instead.
+ */
+PRNode *compactPageRankW(LinkGraph g, char **names, int *outLinks, double damp,
+                         double diffPR, int maxIterations, int method,
+                         int sccThreads, PRTrace trace)
+{
+    int v;
+    double start = traceClock();
+    if (method != INVALID_VAL) reorderLinkGraph(g, method);
+    tracePhase(trace, "reorder", traceClock() - start);
+    traceGraph(trace, g->nURLs, g->nEdges);
+    double *ranks = malloc((g->nURLs + 1) * sizeof(double));
+    assert(ranks != NULL);
+    start = traceClock();
+    if (sccThreads > 0)
+        blockPageRank(g, damp, diffPR, maxIterations, sccThreads, ranks, trace);
+    else
+        linkGraphSweepPageRank(g, damp, diffPR, maxIterations, ranks, trace);
+    tracePhase(trace, "iterate", traceClock() - start);
+
+    // by original ID, so equal ranks sort the same as without relabelling
+    PRNode *urlPRs = malloc(g->nURLs * sizeof(PRNode));
+    for (v = 0; v < g->nURLs; v++) {
+        int id = g->order[v];
+        urlPRs[id] = newPageRankNode(names[id], g->nURLs);
+        urlPRs[id]->nOutLinks = outLinks[id];
+        urlPRs[id]->currPR = ranks[v];
+    }
+    free(ranks);
+    return urlPRs;
+}
+
+
+/* compactPageRankW over the parsed graph. */
+PRNode *graphPageRankW(Graph web, double damp, double diffPR, int maxIterations,
+                       int method, int sccThreads, PRTrace trace)
+{
+    double start = traceClock();
+    LinkGraph g = graphToLinkGraph(web);
+    tracePhase(trace, "compact", traceClock() - start);
+    char **names = malloc((web->numURLs + 1) * sizeof(char *));
+    int *outLinks = malloc((web->numURLs + 1) * sizeof(int));
+    assert(names != NULL && outLinks != NULL);
+    int i;
+    for (i = 0; i < web->numURLs; i++) {
+        names[i] = web->listOfUrls[i]->URLName;
+        outLinks[i] = web->listOfUrls[i]->numOutLinks;
+    }
+    PRNode *urlPRs = compactPageRankW(g, names, outLinks, damp, diffPR, maxIterations,
+                                      method, sccThreads, trace);
+    free(names); free(outLinks);
+    freeLinkGraph(g);
+    return urlPRs;
+}
+
+
+/* compactPageRankW over a graph snapshot. */
+PRNode *snapshotPageRankW(GraphSnapshot snap, double damp, double diffPR, int maxIterations,
+                          int method, int sccThreads, PRTrace trace)
+{
+    double start = traceClock();
+    LinkGraph g = snapshotLinkGraph(snap);
+    tracePhase(trace, "compact", traceClock() - start);
+    PRNode *urlPRs = compactPageRankW(g, snap->names, snap->outLinks, damp, diffPR,
+                                      maxIterations, method, sccThreads, trace);
+    freeLinkGraph(g);
+    return urlPRs;
+}
+
+
+/* Turns the name given to --reorder into a REORDER_ method. */
+int reorderMethod(char *name)
+{
+    if (strcmp(name, "none") == 0) return REORDER_NONE;
+    if (strcmp(name, "degree") == 0) return REORDER_DEGREE;
+    if (strcmp(name, "rcm") == 0) return REORDER_RCM;
+    fprintf(stderr, "Unknown reordering %s\n", name);
+    exit(EXIT_FAILURE);
+}
+
+
 // helper function for the Merge Sort
 void PRmerge(PRNode *array, int start, int middle, int end)
 {
@@ -239,33 +409,146 @@ void dumpPR(PRNode *array, int nElems)
 
 int main(int argc, char **argv)
 {
-    if (argc != REQUIRED_ARGS) {
-        printf("Usage: ./pagerank damping diffPR maxIterations\n");
+    statsInit(&argc, argv);
+    if (argc < REQUIRED_ARGS) {
+        printf("Usage: ./pagerank damping diffPR maxIterations "
+               "[--stream[=MB]] [--reorder=none|degree|rcm] [--scc[=THREADS]] [--shards=N] [--trace[=FILE]] "
+               "[--snapshot] [--stats]\n"
+               "--scc converges to the PageRank fixed point instead of stopping "
+               "like the default mode, so its list can differ\n");
         exit(EXIT_FAILURE);
     } 
     // Get args.
     double damp = atof(argv[DAMPING]);
     double diffPR = atof(argv[DIFFPR]);
     int maxIterations = atoi(argv[MAX_ITER]);
+    int stream = FALSE, memMB = DEFAULT_MEM_MB;
+    int reorder = INVALID_VAL;
+    int sccThreads = 0, nShards = 0;
+    int snapshot = FALSE;
+    PRTrace trace = NULL;
+    int i;
+    for (i = REQUIRED_ARGS; i < argc; i++) {
+        if (strncmp(argv[i], STREAM_FLAG, strlen(STREAM_FLAG)) == 0) {
+            stream = TRUE;
+            char *mb = strchr(argv[i], '=');
+            if (mb != NULL) memMB = atoi(mb + 1);
+        } else if (strncmp(argv[i], REORDER_FLAG, strlen(REORDER_FLAG)) == 0) {
+            reorder = reorderMethod(argv[i] + strlen(REORDER_FLAG));
+        } else if (strncmp(argv[i], SCC_FLAG, strlen(SCC_FLAG)) == 0) {
+            char *threads = strchr(argv[i], '=');
+            sccThreads = threads != NULL ? atoi(threads + 1) : 1;
+            if (sccThreads < 1) sccThreads = 1;
+        } else if (strncmp(argv[i], SHARDS_FLAG, strlen(SHARDS_FLAG)) == 0) {
+            nShards = atoi(argv[i] + strlen(SHARDS_FLAG));
+            if (nShards < 1) nShards = 1;
+        } else if (strncmp(argv[i], TRACE_FLAG, strlen(TRACE_FLAG)) == 0) {
+            char *file = strchr(argv[i], '=');
+            trace = newPRTrace(file != NULL ? file + 1 : NULL);
+        } else if (strncmp(argv[i], SNAPSHOT_FLAG, strlen(SNAPSHOT_FLAG)) == 0) {
+            snapshot = TRUE;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    // the stream reads the edge file, which has its own IDs and no graph
+    if (stream && (snapshot || reorder != INVALID_VAL || sccThreads > 0)) {
+        fprintf(stderr, "%s cannot be used with %s, %s or %s\n", STREAM_FLAG,
+                SNAPSHOT_FLAG, REORDER_FLAG, SCC_FLAG);
+        exit(EXIT_FAILURE);
+    }
+    // the shards read the edge file, which has its own IDs and no graph
+    if (nShards > 0 && (snapshot || reorder != INVALID_VAL || sccThreads > 0)) {
+        fprintf(stderr, "%s cannot be used with %s, %s or %s\n", SHARDS_FLAG,
+                SNAPSHOT_FLAG, REORDER_FLAG, SCC_FLAG);
+        exit(EXIT_FAILURE);
+    }
+    if (nShards > 0) stream = TRUE;
+    // An up to date snapshot stands in for collection.txt and the pages.
+    double start;
+    GraphSnapshot snap = NULL;
+    if (snapshot) {
+        start = traceClock();
+        snap = loadGraphSnapshot(GRAPH_SNAPSHOT);
+        tracePhase(trace, "snapshot", traceClock() - start);
+    }
     // Creates a set of URLs and creates an adjacency list graph.
-    Set URLList = getCollection();
-    Graph web = getGraph(URLList);
-    int nURLs = nElems(URLList);
+    Set URLList = NULL;
+    Graph web = NULL;
+    int nURLs = snap != NULL ? snap->nURLs : 0;
+    if (snap == NULL) {
+        start = traceClock();
+        URLList = getCollection();
+        nURLs = nElems(URLList);
+        tracePhase(trace, "load", traceClock() - start);
+    }
+    if (snap == NULL && !stream) {
+        start = traceClock();
+        web = getGraph(URLList);
+        tracePhase(trace, "graph", traceClock() - start);
+        if (snapshot) {
+            start = traceClock();
+            saveGraphSnapshot(web, GRAPH_SNAPSHOT);
+            tracePhase(trace, "save", traceClock() - start);
+        }
+    }
 
     // Calculates pageranks and sorts them in order.
-    PRNode *urlPRs = PageRankW(URLList, damp, diffPR, maxIterations, web);
-    PRmergeSort(urlPRs, 0, web->numURLs-SHIFT);
+    PRNode *urlPRs;
+    if (stream) {
+        traceSettings(trace, nShards > 0 ? "shards" : "stream", damp, diffPR, maxIterations);
+        urlPRs = streamPageRankW(URLList, damp, diffPR, maxIterations, memMB, nShards, trace);
+    } else if (reorder != INVALID_VAL || sccThreads > 0) {
+        char *mode = sccThreads > 0 ? "scc" : "reorder";
+        traceSettings(trace, mode, damp, diffPR, maxIterations);
+        if (reorder == INVALID_VAL) reorder = REORDER_NONE;
+        if (snap != NULL)
+            urlPRs = snapshotPageRankW(snap, damp, diffPR, maxIterations, reorder,
+                                       sccThreads, trace);
+        else
+            urlPRs = graphPageRankW(web, damp, diffPR, maxIterations, reorder,
+                                    sccThreads, trace);
+    } else if (snap != NULL) {
+        traceSettings(trace, "default", damp, diffPR, maxIterations);
+        urlPRs = snapshotPageRankW(snap, damp, diffPR, maxIterations, INVALID_VAL,
+                                   0, trace);
+    } else {
+        traceSettings(trace, "default", damp, diffPR, maxIterations);
+        start = traceClock();
+        urlPRs = PageRankW(URLList, damp, diffPR, maxIterations, web, trace);
+        tracePhase(trace, "iterate", traceClock() - start);
+    }
+    start = traceClock();
+    PRmergeSort(urlPRs, 0, nURLs-SHIFT);
+    tracePhase(trace, "sort", traceClock() - start);
 
     // Opens file and prints to it.
+    start = traceClock();
     FILE *PRList = fopen("pagerankList.txt", "w");
     if (PRList == NULL) { perror("fopen failed"); exit(EXIT_FAILURE); }
-    int i;
     for(i = nURLs - 1; i >= 0; i--)
         fprintf(PRList, "%s, %d, %.7f\n", urlPRs[i]->name, urlPRs[i]->nOutLinks, urlPRs[i]->currPR);
     fclose(PRList);
+    // binary copy of the list, in the same order
+    char **names = malloc((nURLs + 1) * sizeof(char *));
+    int *outLinks = malloc((nURLs + 1) * sizeof(int));
+    double *ranks = malloc((nURLs + 1) * sizeof(double));
+    assert(names != NULL && outLinks != NULL && ranks != NULL);
+    for (i = 0; i < nURLs; i++) {
+        PRNode node = urlPRs[nURLs - 1 - i];
+        names[i] = node->name;
+        outLinks[i] = node->nOutLinks;
+        ranks[i] = node->currPR;
+    }
+    writeRankTable(RANK_TABLE, "pagerankList.txt", nURLs, names, outLinks, ranks);
+    free(names); free(outLinks); free(ranks);
+    tracePhase(trace, "output", traceClock() - start);
+    finishTrace(trace);
     // free allocated memory
     dumpPR(urlPRs, nURLs);
     disposeSet(URLList);
-    freeGraph(web);
+    if (web != NULL) freeGraph(web);
+    freeGraphSnapshot(snap);
     return 0;
-}
\ No newline at end of file
+}
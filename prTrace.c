@@ -0,0 +1,194 @@
+/* prTrace.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * FORMAT (JSON):
+ *  {"mode": ..., "damping": ..., "diffPR": ..., "maxIterations": ...,
+ *   "urls": ..., "edges": ...,
+ *   "phases": {"load": s, "graph": s, "iterate": s, "sort": s, "output": s},
+ *   "iterations": [{"iter": 1, "residual": r, "seconds": s,
+ *                   "edgesPerSec": e}, ...]}
+ * FORMAT (CSV):
+ *  kind,name,iter,residual,seconds,edges_per_sec
+ *  one "phase" row per phase then one "iteration" row per iteration.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "prTrace.h"
+#include "mystring.h"
+#include "stats.h"
+
+#define MAX_PHASES  16
+#define INIT_ITERS  64
+#define CSV_EXT     ".csv"
+
+typedef struct iterRecord {
+    double residual;
+    double seconds;
+    long   edges;
+} IterRecord;
+
+struct prTrace {
+    char  *fileName;
+    int    format;
+    char  *mode;
+    double damp;
+    double diffPR;
+    int    maxIterations;
+    int    nURLs;
+    long   nEdges;
+    int    nPhases;
+    char  *phaseName[MAX_PHASES];
+    double phaseSeconds[MAX_PHASES];
+    int    nIters;
+    int    capIters;
+    IterRecord *iters;
+    double lastTick;
+};
+
+
+double traceClock()
+{
+    return statsClock();
+}
+
+
+PRTrace newPRTrace(char *fileName)
+{
+    PRTrace t = calloc(1, sizeof(struct prTrace));
+    assert(t != NULL);
+    if (fileName != NULL && strcmp(fileName, "-") != 0) {
+        t->fileName = mystrdup(fileName);
+        int len = strlen(fileName);
+        if (len >= (int)strlen(CSV_EXT) && strcmp(fileName + len - strlen(CSV_EXT), CSV_EXT) == 0)
+            t->format = TRACE_CSV;
+    }
+    t->mode = mystrdup("default");
+    t->capIters = INIT_ITERS;
+    t->iters = malloc(t->capIters * sizeof(IterRecord));
+    assert(t->iters != NULL);
+    t->lastTick = traceClock();
+    return t;
+}
+
+
+void traceSettings(PRTrace t, char *mode, double damp, double diffPR, int maxIterations)
+{
+    if (t == NULL) return;
+    free(t->mode);
+    t->mode = mystrdup(mode);
+    t->damp = damp;
+    t->diffPR = diffPR;
+    t->maxIterations = maxIterations;
+}
+
+
+void traceGraph(PRTrace t, int nURLs, long nEdges)
+{
+    if (t == NULL) return;
+    t->nURLs = nURLs;
+    t->nEdges = nEdges;
+}
+
+
+void traceStartIterations(PRTrace t)
+{
+    if (t == NULL) return;
+    t->lastTick = traceClock();
+}
+
+
+void traceRecord(PRTrace t, double residual, long edges, double seconds)
+{
+    if (t == NULL) return;
+    if (t->nIters == t->capIters) {
+        t->capIters *= 2;
+        t->iters = realloc(t->iters, t->capIters * sizeof(IterRecord));
+        assert(t->iters != NULL);
+    }
+    IterRecord *r = &t->iters[t->nIters++];
+    r->residual = residual;
+    r->seconds = seconds;
+    r->edges = edges;
+}
+
+
+void traceIteration(PRTrace t, double residual, long edges)
+{
+    if (t == NULL) return;
+    double tick = traceClock();
+    traceRecord(t, residual, edges, tick - t->lastTick);
+    t->lastTick = tick;
+}
+
+
+void tracePhase(PRTrace t, char *name, double seconds)
+{
+    // phases are the pagerank timers of --stats as well
+    statsAddTime(name, seconds);
+    if (t == NULL || t->nPhases == MAX_PHASES) return;
+    t->phaseName[t->nPhases] = mystrdup(name);
+    t->phaseSeconds[t->nPhases] = seconds;
+    t->nPhases++;
+}
+
+
+// edges per second of one iteration, 0 when too fast to time
+static double edgeRate(IterRecord *r)
+{
+    return r->seconds > 0 ? r->edges / r->seconds : 0;
+}
+
+
+static void writeJSON(PRTrace t, FILE *out)
+{
+    int i;
+    fprintf(out, "{\"mode\": \"%s\", \"damping\": %g, \"diffPR\": %g, \"maxIterations\": %d,\n",
+            t->mode, t->damp, t->diffPR, t->maxIterations);
+    fprintf(out, " \"urls\": %d, \"edges\": %ld,\n \"phases\": {", t->nURLs, t->nEdges);
+    for (i = 0; i < t->nPhases; i++)
+        fprintf(out, "%s\"%s\": %.6f", i ? ", " : "", t->phaseName[i], t->phaseSeconds[i]);
+    fprintf(out, "},\n \"iterations\": [");
+    for (i = 0; i < t->nIters; i++) {
+        fprintf(out, "%s\n  {\"iter\": %d, \"residual\": %.10g, \"seconds\": %.6f, \"edgesPerSec\": %.0f}",
+                i ? "," : "", i + 1, t->iters[i].residual, t->iters[i].seconds, edgeRate(&t->iters[i]));
+    }
+    fprintf(out, "\n ]}\n");
+}
+
+
+static void writeCSV(PRTrace t, FILE *out)
+{
+    int i;
+    fprintf(out, "kind,name,iter,residual,seconds,edges_per_sec\n");
+    for (i = 0; i < t->nPhases; i++)
+        fprintf(out, "phase,%s,,,%.6f,\n", t->phaseName[i], t->phaseSeconds[i]);
+    for (i = 0; i < t->nIters; i++)
+        fprintf(out, "iteration,%s,%d,%.10g,%.6f,%.0f\n", t->mode, i + 1,
+                t->iters[i].residual, t->iters[i].seconds, edgeRate(&t->iters[i]));
+}
+
+
+void finishTrace(PRTrace t)
+{
+    if (t == NULL) return;
+    FILE *out = stderr;
+    if (t->fileName != NULL) {
+        out = fopen(t->fileName, "w");
+        if (!out) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    }
+    if (t->format == TRACE_CSV) writeCSV(t, out);
+    else writeJSON(t, out);
+    if (out != stderr) fclose(out);
+
+    int i;
+    for (i = 0; i < t->nPhases; i++) free(t->phaseName[i]);
+    free(t->iters); free(t->mode); free(t->fileName);
+    free(t);
+}
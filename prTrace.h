@@ -0,0 +1,39 @@
+/* prTrace.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Convergence and throughput trace for pagerank. Records the residual,
+ * wall time and edges processed of every iteration plus the time spent
+ * in each phase, and writes them as JSON or CSV when finished.
+ * Every function accepts a NULL trace and does nothing with it.
+ */
+
+#ifndef PRTRACE_H
+#define PRTRACE_H
+
+#define TRACE_JSON  0
+#define TRACE_CSV   1
+
+typedef struct prTrace *PRTrace;
+
+// fileName NULL or "-" writes to stderr; a .csv name selects CSV
+PRTrace newPRTrace(char *fileName);
+// seconds from an arbitrary fixed point, monotonic
+double traceClock();
+// records run parameters written in the header
+void traceSettings(PRTrace, char *mode, double damp, double diffPR, int maxIterations);
+// records graph size
+void traceGraph(PRTrace, int nURLs, long nEdges);
+// records an iteration; time is measured since the previous call
+void traceIteration(PRTrace, double residual, long edges);
+// records an iteration whose time was measured elsewhere
+void traceRecord(PRTrace, double residual, long edges, double seconds);
+// marks the start of the iterations (resets the per-iteration clock)
+void traceStartIterations(PRTrace);
+// records the time spent in a phase
+void tracePhase(PRTrace, char *name, double seconds);
+// writes the trace out and frees it
+void finishTrace(PRTrace);
+
+#endif
@@ -0,0 +1,525 @@
+/* rankAgg.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * SCALED FOOTRULE AGGREGATION:
+ * 1. Represent cost matrix in an n x n row-major array
+ *    - Rows: urls in the union
+ *    - Cols: possible positions
+ * 2. Calculate the footrule distance for each [row][col], a row at a
+ *    time from the url's normalised positions (see footrule.c)
+ * 3. Find the minimum cost assignment of urls to positions with the
+ *    Hungarian algorithm (see assignment.c).
+ * 4. Return the total distance and the urls ordered by position.
+ *
+ * WARM START: the Hungarian state of the last full exact solve is kept
+ * with the lists it was for. A URL's cost row only changes if it moved
+ * within a list or the list's length changed, so with opts->warm only
+ * those rows are rebuilt and re-augmented: O(changed * n^2) instead of
+ * O(n^3). The state can be written to a file and read back.
+ *
+ * TOP-K: only positions 1 .. k are assigned. Every other URL goes to a
+ * tail bucket and pays the cost of its cheapest position after k; the
+ * cost is convex in the position, so that is next to its median.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "rankAgg.h"
+#include "assignment.h"
+#include "footrule.h"
+#include "aggregate.h"
+
+#define MIN(X, Y)  ( (X < Y) ? X : Y)
+#define MAX(X, Y)  ( (X > Y) ? X : Y)
+#define TRUE            1
+#define FALSE           0
+#define DEFAULT_EPS     1e-7
+#define DEFAULT_BAND    32
+#define BAND_TOLERANCE  1e-9
+#define STATE_MAGIC     0x53474741  // "AGGS"
+
+struct rankAgg {
+    int      nURLs;
+    int      capURLs;
+    long     capNorm;
+    double  *normData;  // normalised positions of all URLs, URL by URL
+    double **norm;      // norm[u] points at URL u's positions
+    int     *nNorm;
+    int      maxNorm;
+    double  *scratch;   // maxNorm doubles
+    int      capScratch;
+    int     *assign;    // position of every URL
+    double  *slots;     // footruleSlots(nURLs)
+    double  *cost;
+    size_t   capCost;
+    // warm start: the last full Hungarian solve and the lists it was for
+    AssignState state;
+    int      costValid; // cost still holds that solve's n x n matrix
+    int      nPrevLists;
+    int     *prevLen;
+    long    *prevStart;
+    int     *prevIds;
+    char    *changed;   // capURLs flags
+};
+
+
+RankAgg newRankAgg()
+{
+    RankAgg agg = calloc(1, sizeof(struct rankAgg));
+    assert(agg != NULL);
+    return agg;
+}
+
+
+void disposeRankAgg(RankAgg agg)
+{
+    if (agg == NULL) return;
+    free(agg->normData); free(agg->norm); free(agg->nNorm);
+    free(agg->scratch); free(agg->assign); free(agg->slots);
+    free(agg->cost);
+    freeAssignState(agg->state);
+    free(agg->prevLen); free(agg->prevStart); free(agg->prevIds);
+    free(agg->changed);
+    free(agg);
+}
+
+
+void defaultAggOptions(AggOptions *opts)
+{
+    opts->mode = AGG_EXACT;
+    opts->solver = SOLVER_HUNGARIAN;
+    opts->eps = DEFAULT_EPS;
+    opts->nThreads = 1;
+    opts->band = DEFAULT_BAND;
+    opts->window = MC_WINDOW;
+    opts->top = 0;
+    opts->warm = FALSE;
+}
+
+
+int aggModeByName(char *name)
+{
+    char *names[] = { "exact", "median", "borda", "markov" };
+    int i;
+    for (i = 0; i < 4; i++) if (strcmp(name, names[i]) == 0) return i;
+    return UNKNOWN_NAME;
+}
+
+
+int aggSolverByName(char *name)
+{
+    char *names[] = { "hungarian", "auction", "banded" };
+    int i;
+    for (i = 0; i < 3; i++) if (strcmp(name, names[i]) == 0) return i;
+    return UNKNOWN_NAME;
+}
+
+
+int aggOrderLength(int nURLs, AggOptions *opts)
+{
+    return (opts->top > 0 && opts->top < nURLs) ? opts->top : nURLs;
+}
+
+
+// cost buffer of at least size doubles
+static double *costBuffer(RankAgg agg, size_t size)
+{
+    if (size > agg->capCost) {
+        free(agg->cost);
+        agg->capCost = size;
+        agg->cost = malloc((size + 1) * sizeof(double));
+        assert(agg->cost != NULL);
+    }
+    return agg->cost;
+}
+
+
+/* Turns the lists into the normalised positions of every URL, growing
+ * the buffers only when this call needs more than an earlier one.
+ */
+static void loadLists(RankAgg agg, int **lists, int *listLen, int nLists, int nURLs)
+{
+    int k, p, u;
+    long total = 0;
+    if (nURLs > agg->capURLs || agg->slots == NULL || agg->nURLs != nURLs) {
+        if (nURLs > agg->capURLs) {
+            agg->capURLs = nURLs;
+            free(agg->norm); free(agg->nNorm); free(agg->assign); free(agg->changed);
+            agg->norm = malloc((nURLs + 1) * sizeof(double *));
+            agg->nNorm = malloc((nURLs + 1) * sizeof(int));
+            agg->assign = malloc((nURLs + 1) * sizeof(int));
+            agg->changed = malloc((nURLs + 1) * sizeof(char));
+            assert(agg->norm != NULL && agg->nNorm != NULL && agg->assign != NULL);
+            assert(agg->changed != NULL);
+        }
+        free(agg->slots);
+        agg->slots = footruleSlots(nURLs);
+    }
+    agg->nURLs = nURLs;
+
+    for (u = 0; u < nURLs; u++) agg->nNorm[u] = 0;
+    for (k = 0; k < nLists; k++) {
+        for (p = 0; p < listLen[k]; p++) agg->nNorm[lists[k][p]]++;
+        total += listLen[k];
+    }
+    if (total > agg->capNorm) {
+        agg->capNorm = total;
+        free(agg->normData);
+        agg->normData = malloc((total + 1) * sizeof(double));
+        assert(agg->normData != NULL);
+    }
+    agg->maxNorm = 0;
+    double *next = agg->normData;
+    for (u = 0; u < nURLs; u++) {
+        agg->norm[u] = next;
+        next += agg->nNorm[u];
+        agg->maxNorm = MAX(agg->maxNorm, agg->nNorm[u]);
+        agg->nNorm[u] = 0;
+    }
+    if (agg->maxNorm > agg->capScratch) {
+        agg->capScratch = agg->maxNorm;
+        free(agg->scratch);
+        agg->scratch = malloc((agg->maxNorm + 1) * sizeof(double));
+        assert(agg->scratch != NULL);
+    }
+    // position is indexed starting at 1, not 0
+    for (k = 0; k < nLists; k++) {
+        for (p = 0; p < listLen[k]; p++) {
+            u = lists[k][p];
+            agg->norm[u][agg->nNorm[u]++] = (p + 1) / (double)listLen[k];
+        }
+    }
+}
+
+
+/* Builds the n x n row-major cost matrix: cost[url * n + pos]. */
+static double *buildCostMatrix(RankAgg agg)
+{
+    int n = agg->nURLs, row;
+    double *cost = costBuffer(agg, (size_t)n * n);
+    for (row = 0; row < n; row++)
+        footruleRow(cost + (size_t)row * n, agg->norm[row], agg->nNorm[row],
+                    agg->slots, n);
+    return cost;
+}
+
+
+/* Checks the potentials of a banded solve against the costs outside
+ * the bands, one row at a time. Returns TRUE if no reduced cost is
+ * negative, i.e. the banded assignment is optimal.
+ */
+static int bandIsOptimal(RankAgg agg, double *u, double *v)
+{
+    int n = agg->nURLs;
+    double *row = malloc((n + 1) * sizeof(double));
+    assert(row != NULL);
+    int i, j, optimal = TRUE;
+    for (i = 0; i < n && optimal; i++) {
+        footruleRow(row, agg->norm[i], agg->nNorm[i], agg->slots, n);
+        for (j = 0; j < n; j++) {
+            if (row[j] - u[i] - v[j] < -BAND_TOLERANCE) { optimal = FALSE; break; }
+        }
+    }
+    free(row);
+    return optimal;
+}
+
+
+/* Solves the assignment over a band of positions around each URL's
+ * median position, where its cost is lowest, doubling the band until
+ * every URL can be placed and no position outside the bands would do
+ * better. Only n x (2 * band + 1) costs are stored.
+ */
+static double bandedAggregate(RankAgg agg, int band, int *assign)
+{
+    int n = agg->nURLs, i;
+    int *centre = malloc((n + 1) * sizeof(int));
+    int *bandStart = malloc((n + 1) * sizeof(int));
+    double *u = malloc((n + 1) * sizeof(double));
+    double *v = malloc((n + 1) * sizeof(double));
+    assert(centre != NULL && bandStart != NULL && u != NULL && v != NULL);
+    for (i = 0; i < n; i++) {
+        double median = medianPosition(agg->norm[i], agg->nNorm[i], agg->scratch);
+        centre[i] = (int)ceil(median * n) - 1;
+    }
+    double sum = INFEASIBLE;
+    if (band < 1) band = 1;
+    while (TRUE) {
+        int width = MIN(2 * band + 1, n);
+        double *cost = costBuffer(agg, (size_t)n * width);
+        for (i = 0; i < n; i++) {
+            bandStart[i] = MIN(MAX(centre[i] - band, 0), n - width);
+            footruleRow(cost + (size_t)i * width, agg->norm[i], agg->nNorm[i],
+                        agg->slots + bandStart[i], width);
+        }
+        // once the band is everything the dense solver is faster
+        if (width == n) {
+            sum = hungarian(cost, n, n, assign);
+            break;
+        }
+        sum = bandedAssignment(cost, bandStart, width, n, assign, u, v);
+        if (sum != INFEASIBLE && bandIsOptimal(agg, u, v)) break;
+        band *= 2;
+    }
+    free(centre); free(bandStart); free(u); free(v);
+    return sum;
+}
+
+
+/* Cost of URL i in the tail bucket after the top k: the footrule cost
+ * of its cheapest position from k + 1 to n, a position next to its
+ * median clamped into the tail.
+ */
+static double tailCost(RankAgg agg, int i, int k)
+{
+    int n = agg->nURLs;
+    double median = medianPosition(agg->norm[i], agg->nNorm[i], agg->scratch);
+    int below = MIN(MAX((int)floor(median * n), k + 1), n);
+    int above = MIN(MAX((int)ceil(median * n), k + 1), n);
+    return fmin(footruleCost(agg->norm[i], agg->nNorm[i], below / (double)n),
+                footruleCost(agg->norm[i], agg->nNorm[i], above / (double)n));
+}
+
+
+/* Footrule distance of an assignment when only positions below k count
+ * and every other URL pays its tail cost.
+ */
+static double topKDistance(RankAgg agg, int k, int *assign)
+{
+    int n = agg->nURLs, i;
+    double sum = 0;
+    for (i = 0; i < n; i++) {
+        if (assign[i] < k)
+            sum += footruleCost(agg->norm[i], agg->nNorm[i], (assign[i] + 1) / (double)n);
+        else
+            sum += tailCost(agg, i, k);
+    }
+    return sum;
+}
+
+
+/* Top-k aggregation: the total is the sum of every tail cost plus, for
+ * the k URLs placed, what their position costs over their tail cost.
+ * So positions (rows) are assigned to URLs (columns) of the k x n
+ * matrix cost[p * n + i] = c(i, p) - tail(i). URLs left over get
+ * position k in assign.
+ */
+static double topKAggregate(RankAgg agg, int k, int *assign)
+{
+    int n = agg->nURLs, i, p;
+    double *cost = costBuffer(agg, (size_t)k * n);
+    double *row = malloc((k + 1) * sizeof(double));
+    int *posAssign = malloc((k + 1) * sizeof(int));
+    assert(row != NULL && posAssign != NULL);
+    double tails = 0;
+    for (i = 0; i < n; i++) {
+        double tail = tailCost(agg, i, k);
+        tails += tail;
+        footruleRow(row, agg->norm[i], agg->nNorm[i], agg->slots, k);
+        for (p = 0; p < k; p++) cost[(size_t)p * n + i] = row[p] - tail;
+    }
+    double sum = tails + hungarian(cost, k, n, posAssign);
+    for (i = 0; i < n; i++) assign[i] = k;
+    for (p = 0; p < k; p++) assign[posAssign[p]] = p;
+    free(row); free(posAssign);
+    return sum;
+}
+
+
+// keeps a copy of the lists the warm start state belongs to
+static void savePrevLists(RankAgg agg, int **lists, int *listLen, int nLists)
+{
+    int k;
+    long total = 0;
+    free(agg->prevLen); free(agg->prevStart); free(agg->prevIds);
+    agg->prevLen = malloc((nLists + 1) * sizeof(int));
+    agg->prevStart = malloc((nLists + 1) * sizeof(long));
+    assert(agg->prevLen != NULL && agg->prevStart != NULL);
+    for (k = 0; k < nLists; k++) {
+        agg->prevStart[k] = total;
+        agg->prevLen[k] = listLen[k];
+        total += listLen[k];
+    }
+    agg->prevIds = malloc((total + 1) * sizeof(int));
+    assert(agg->prevIds != NULL);
+    for (k = 0; k < nLists; k++)
+        memcpy(agg->prevIds + agg->prevStart[k], lists[k], listLen[k] * sizeof(int));
+    agg->nPrevLists = nLists;
+}
+
+
+/* Flags the URLs whose normalised positions differ from the previous
+ * lists': those that moved within a list, and every URL of a list whose
+ * length changed. Returns the number flagged.
+ */
+static int markChanged(RankAgg agg, int **lists, int *listLen, int nLists)
+{
+    int n = agg->nURLs, k, p, u, nChanged = 0;
+    for (u = 0; u < n; u++) agg->changed[u] = FALSE;
+    for (k = 0; k < nLists; k++) {
+        int *prev = agg->prevIds + agg->prevStart[k];
+        int sameLength = listLen[k] == agg->prevLen[k];
+        for (p = 0; p < agg->prevLen[k]; p++)
+            if (!sameLength || prev[p] != lists[k][p]) agg->changed[prev[p]] = TRUE;
+        for (p = 0; p < listLen[k]; p++)
+            if (!sameLength || prev[p] != lists[k][p]) agg->changed[lists[k][p]] = TRUE;
+    }
+    for (u = 0; u < n; u++) nChanged += agg->changed[u];
+    return nChanged;
+}
+
+
+/* Full exact solve with the Hungarian algorithm. With warm set and a
+ * previous solve over the same URLs and number of lists, only the rows
+ * of URLs whose positions changed are rebuilt and solved again.
+ */
+static double hungarianAggregate(RankAgg agg, int **lists, int *listLen,
+                                 int nLists, int warm, int *assign)
+{
+    int n = agg->nURLs, u;
+    double *cost;
+    if (warm && agg->state != NULL && agg->state->nRows == n
+        && agg->nPrevLists == nLists) {
+        markChanged(agg, lists, listLen, nLists);
+        if (agg->costValid) {
+            cost = agg->cost;
+            for (u = 0; u < n; u++) {
+                if (!agg->changed[u]) continue;
+                footruleRow(cost + (size_t)u * n, agg->norm[u], agg->nNorm[u],
+                            agg->slots, n);
+            }
+        } else {
+            cost = buildCostMatrix(agg);
+        }
+        for (u = 0; u < n; u++)
+            if (agg->changed[u]) resetAssignRow(agg->state, cost, u);
+    } else {
+        cost = buildCostMatrix(agg);
+        freeAssignState(agg->state);
+        agg->state = newAssignState(n, n);
+    }
+    double sum = hungarianSolve(agg->state, cost, assign);
+    agg->costValid = TRUE;
+    savePrevLists(agg, lists, listLen, nLists);
+    return sum;
+}
+
+
+/* Exact aggregation: 1. - 3. above. Fills assign and returns the
+ * minimum scaled footrule distance (eps-optimal with the auction).
+ */
+static double exactAggregate(RankAgg agg, int **lists, int *listLen, int nLists,
+                             AggOptions *opts, int *assign)
+{
+    int n = agg->nURLs;
+    if (opts->solver == SOLVER_HUNGARIAN && (opts->top <= 0 || opts->top >= n))
+        return hungarianAggregate(agg, lists, listLen, nLists, opts->warm, assign);
+    // the other solvers overwrite the cost buffer
+    agg->costValid = FALSE;
+    if (opts->top > 0 && opts->top < n)
+        return topKAggregate(agg, opts->top, assign);
+    if (opts->solver == SOLVER_BANDED)
+        return bandedAggregate(agg, opts->band, assign);
+    /* 1. & 2. Represent a cost matrix with an n x n row-major array and
+          calculate the footrule distance for each cost[url * n + pos] */
+    double *cost = buildCostMatrix(agg);
+    /* 3. Minimum cost assignment of urls to positions */
+    return auction(cost, n, opts->eps, opts->nThreads, assign);
+}
+
+
+void writeAggState(RankAgg agg, FILE *file)
+{
+    int magic = STATE_MAGIC, n = agg->state == NULL ? 0 : agg->state->nRows;
+    int nLists = agg->state == NULL ? 0 : agg->nPrevLists;
+    fwrite(&magic, sizeof(int), 1, file);
+    fwrite(&n, sizeof(int), 1, file);
+    fwrite(&nLists, sizeof(int), 1, file);
+    if (n == 0) return;
+    long total = agg->prevStart[nLists - 1] + agg->prevLen[nLists - 1];
+    fwrite(agg->prevLen, sizeof(int), nLists, file);
+    fwrite(agg->prevIds, sizeof(int), total, file);
+    fwrite(agg->state->u, sizeof(double), n + 1, file);
+    fwrite(agg->state->v, sizeof(double), n + 1, file);
+    fwrite(agg->state->rowOf, sizeof(int), n + 1, file);
+}
+
+
+int readAggState(RankAgg agg, FILE *file)
+{
+    int magic, n, nLists, k;
+    if (fread(&magic, sizeof(int), 1, file) != 1 || magic != STATE_MAGIC) return FALSE;
+    if (fread(&n, sizeof(int), 1, file) != 1 || n <= 0) return FALSE;
+    if (fread(&nLists, sizeof(int), 1, file) != 1 || nLists <= 0) return FALSE;
+    int *listLen = malloc(nLists * sizeof(int));
+    int **lists = malloc(nLists * sizeof(int *));
+    assert(listLen != NULL && lists != NULL);
+    int ok = fread(listLen, sizeof(int), nLists, file) == nLists;
+    long total = 0;
+    for (k = 0; ok && k < nLists; k++) {
+        if (listLen[k] < 0) ok = FALSE;
+        else total += listLen[k];
+    }
+    int *ids = ok ? malloc((total + 1) * sizeof(int)) : NULL;
+    AssignState state = ok ? newAssignState(n, n) : NULL;
+    ok = ok && fread(ids, sizeof(int), total, file) == total;
+    ok = ok && fread(state->u, sizeof(double), n + 1, file) == n + 1;
+    ok = ok && fread(state->v, sizeof(double), n + 1, file) == n + 1;
+    ok = ok && fread(state->rowOf, sizeof(int), n + 1, file) == n + 1;
+    for (k = 0; ok && k < total; k++) if (ids[k] < 0 || ids[k] >= n) ok = FALSE;
+    for (k = 0; ok && k <= n; k++) if (state->rowOf[k] < 0 || state->rowOf[k] > n) ok = FALSE;
+    if (ok) {
+        total = 0;
+        for (k = 0; k < nLists; k++) { lists[k] = ids + total; total += listLen[k]; }
+        savePrevLists(agg, lists, listLen, nLists);
+        freeAssignState(agg->state);
+        agg->state = state;
+        agg->costValid = FALSE;
+    } else {
+        freeAssignState(state);
+    }
+    free(ids); free(lists); free(listLen);
+    return ok;
+}
+
+
+double aggregateRanks(RankAgg agg, int **lists, int *listLen, int nLists,
+                      int nURLs, AggOptions *opts, int *order)
+{
+    if (nURLs == 0) return 0;
+    loadLists(agg, lists, listLen, nLists, nURLs);
+    int *assign = agg->assign;
+    int nOrder = aggOrderLength(nURLs, opts);
+    double sum = 0;
+    switch (opts->mode) {
+    case AGG_EXACT:
+        sum = exactAggregate(agg, lists, listLen, nLists, opts, assign);
+        break;
+    case AGG_MEDIAN:
+        medianAggregate(agg->norm, agg->nNorm, nURLs, assign);
+        break;
+    case AGG_BORDA:
+        bordaAggregate(agg->norm, agg->nNorm, nURLs, assign);
+        break;
+    case AGG_MARKOV:
+        markovAggregate(lists, listLen, nLists, nURLs, opts->window, assign);
+        break;
+    default:
+        fprintf(stderr, "Unknown aggregation mode %d\n", opts->mode);
+        exit(EXIT_FAILURE);
+    }
+    if (opts->mode != AGG_EXACT) {
+        if (nOrder < nURLs) sum = topKDistance(agg, nOrder, assign);
+        else sum = footruleDistance(agg->norm, agg->nNorm, nURLs, assign);
+    }
+    // 4. urls ordered by position
+    int i;
+    for (i = 0; i < nURLs; i++)
+        if (assign[i] < nOrder) order[assign[i]] = i;
+    return sum;
+}
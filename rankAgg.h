@@ -0,0 +1,73 @@
+/* rankAgg.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Rank aggregation library behind scaledFootrule. Rank lists are passed
+ * in memory as arrays of URL IDs 0 .. nURLs-1 in rank order, so a caller
+ * can merge result lists in-process (e.g. per search query) without
+ * files. An aggregator keeps its cost matrix and other buffers between
+ * calls and only grows them, so repeated merges do not reallocate.
+ */
+
+#ifndef RANKAGG_H
+#define RANKAGG_H
+
+#include <stdio.h>
+
+// aggregation modes
+#define AGG_EXACT           0   // minimum scaled footrule distance
+#define AGG_MEDIAN          1
+#define AGG_BORDA           2
+#define AGG_MARKOV          3   // MC4
+
+// exact mode solvers
+#define SOLVER_HUNGARIAN    0
+#define SOLVER_AUCTION      1
+#define SOLVER_BANDED       2
+
+#define UNKNOWN_NAME        -1
+
+typedef struct aggOptions {
+    int    mode;
+    int    solver;      // exact mode only
+    double eps;         // auction bid increment, result within n * eps
+    int    nThreads;    // auction bidding threads
+    int    band;        // banded: initial positions either side of a median
+    int    window;      // markov: comparisons per list place, 0 for all
+    int    top;         // if 0 < top < nURLs only place the top positions,
+                        // with its own solver: solver and warm are ignored
+    int    warm;        // exact Hungarian: resume from the previous call,
+                        // re-solving only URLs whose positions changed
+} AggOptions;
+
+typedef struct rankAgg *RankAgg;
+
+RankAgg newRankAgg();
+void disposeRankAgg(RankAgg);
+// exact mode with the Hungarian solver, full ranking
+void defaultAggOptions(AggOptions *);
+// mode and solver numbers by name, UNKNOWN_NAME if there is none
+int aggModeByName(char *name);
+int aggSolverByName(char *name);
+// number of URLs a call with these options places
+int aggOrderLength(int nURLs, AggOptions *);
+
+/* Aggregates nLists rank lists; lists[k] holds listLen[k] URL IDs best
+ * first. order receives aggOrderLength(nURLs, opts) URL IDs by position.
+ * Returns the scaled footrule distance of the result (with a top limit,
+ * of the top positions plus every other URL's tail cost, see rankAgg.c).
+ * IDs that are in no list cost the same anywhere.
+ */
+double aggregateRanks(RankAgg, int **lists, int *listLen, int nLists,
+                      int nURLs, AggOptions *opts, int *order);
+
+/* Saves / restores the warm start state (the last full exact Hungarian
+ * solve and its lists) so a later process can resume from it. URL IDs
+ * must mean the same URLs in both. readAggState returns FALSE and leaves
+ * the aggregator unchanged if the file is not a valid state.
+ */
+void writeAggState(RankAgg, FILE *);
+int readAggState(RankAgg, FILE *);
+
+#endif
@@ -0,0 +1,172 @@
+/* rankTable.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * FILE LAYOUT:
+ *  TableHeader
+ *  RankEntry entry[nURLs]      in list order
+ *  int       slot[nSlots]      open addressing on hashString(name), linear
+ *                              probing; position of the URL or -1
+ *  char      names[namesSize]  the URLs, each NUL-terminated
+ * nSlots is a power of two at least twice nURLs, so probes are short.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "rankTable.h"
+#include "hashMap.h"
+#include "stats.h"
+#include "fileUtil.h"
+
+#define TRUE        1
+#define FALSE       0
+#define EMPTY       -1
+#define MAX_NAME    1024
+
+typedef struct tableHeader {
+    int  magic;
+    int  nURLs;
+    int  nSlots;
+    int  unused;
+    long namesSize;
+    long listSize;      // size and modification time (ns) of the list
+    long listTime;      // the table was made from
+} TableHeader;
+
+typedef struct rankEntry {
+    double rank;
+    int    outLinks;
+    int    name;        // offset in names
+} RankEntry;
+
+struct rankTable {
+    TableHeader *header;
+    RankEntry   *entry;
+    int         *slot;
+    char        *names;
+    long         mapSize;
+};
+
+
+void writeRankTable(char *tableName, char *listName, int n, char **names,
+                    int *outLinks, double *ranks)
+{
+    TableHeader h = { RANK_MAGIC, n, 1, 0, 0, 0, 0 };
+    if (!fileVersion(listName, &h.listSize, &h.listTime)) return;
+    while (h.nSlots < 2 * n) h.nSlots *= 2;
+    RankEntry *entry = malloc((n + 1) * sizeof(RankEntry));
+    int *slot = malloc(h.nSlots * sizeof(int));
+    assert(entry != NULL && slot != NULL);
+    memset(slot, EMPTY, h.nSlots * sizeof(int));
+    int i;
+    for (i = 0; i < n; i++) {
+        entry[i].rank = ranks[i];
+        entry[i].outLinks = outLinks[i];
+        entry[i].name = h.namesSize;
+        h.namesSize += strlen(names[i]) + 1;
+        unsigned int s = hashString(names[i]) & (h.nSlots - 1);
+        while (slot[s] != EMPTY) s = (s + 1) & (h.nSlots - 1);
+        slot[s] = i;
+    }
+    // written under another name and renamed, so readers never map half
+    char tmpName[MAX_NAME];
+    FILE *file = openTemp(tableName, tmpName, MAX_NAME);
+    fwrite(&h, sizeof(TableHeader), 1, file);
+    fwrite(entry, sizeof(RankEntry), n, file);
+    fwrite(slot, sizeof(int), h.nSlots, file);
+    for (i = 0; i < n; i++) fwrite(names[i], 1, strlen(names[i]) + 1, file);
+    commitTemp(file, tmpName, tableName);
+    free(entry); free(slot);
+}
+
+
+RankTable loadRankTable(char *tableName, char *listName)
+{
+    int fd = open(tableName, O_RDONLY);
+    if (fd < 0) return NULL;
+    STATS_ADD(STAT_FILES, 1);
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= sizeof(TableHeader))
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    // only the header is checked, so loading does not touch the rest
+    TableHeader *h = map;
+    long size, time;
+    int valid = h->magic == RANK_MAGIC && h->nURLs >= 0 && h->nSlots > 0
+             && (h->nSlots & (h->nSlots - 1)) == 0 && h->namesSize >= 0
+             && sizeof(TableHeader) + h->nURLs * sizeof(RankEntry)
+                + h->nSlots * sizeof(int) + h->namesSize == st.st_size
+             && (h->namesSize == 0 || ((char *)map)[st.st_size - 1] == '\0')
+             && fileVersion(listName, &size, &time)
+             && size == h->listSize && time == h->listTime;
+    if (!valid) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    RankTable table = malloc(sizeof(struct rankTable));
+    assert(table != NULL);
+    table->header = h;
+    table->entry = (RankEntry *)(h + 1);
+    table->slot = (int *)(table->entry + h->nURLs);
+    table->names = (char *)(table->slot + h->nSlots);
+    table->mapSize = st.st_size;
+    return table;
+}
+
+
+void freeRankTable(RankTable table)
+{
+    if (table == NULL) return;
+    munmap(table->header, table->mapSize);
+    free(table);
+}
+
+
+int rankTableSize(RankTable table)
+{
+    return table->header->nURLs;
+}
+
+
+int rankTableFind(RankTable table, char *url)
+{
+    int mask = table->header->nSlots - 1, probes;
+    unsigned int s = hashString(url) & mask;
+    for (probes = 0; probes <= mask && table->slot[s] != EMPTY; probes++, s = (s + 1) & mask) {
+        int pos = table->slot[s];
+        if (pos < 0 || pos >= table->header->nURLs) return EMPTY;
+        if (table->entry[pos].name < 0 || table->entry[pos].name >= table->header->namesSize)
+            return EMPTY;
+        if (STATS_STRCMP(table->names + table->entry[pos].name, url) == 0) return pos;
+    }
+    return EMPTY;
+}
+
+
+char *rankTableURL(RankTable table, int pos)
+{
+    return table->names + table->entry[pos].name;
+}
+
+
+int rankTableOutLinks(RankTable table, int pos)
+{
+    return table->entry[pos].outLinks;
+}
+
+
+double rankTableRank(RankTable table, int pos)
+{
+    return table->entry[pos].rank;
+}
@@ -0,0 +1,37 @@
+/* rankTable.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Binary copy of pagerankList.txt that searchPagerank memory maps
+ * instead of parsing the list: the URLs in the same order with their
+ * out-degree and rank, and a hash table from URL name to position. The
+ * pages of the file are shared by every process reading it.
+ */
+
+#ifndef RANKTABLE_H
+#define RANKTABLE_H
+
+#define RANK_MAGIC  0x31544b52  // "RKT1"
+#define RANK_TABLE  "pagerankList.bin"
+
+typedef struct rankTable *RankTable;
+
+/* Writes the n URLs (names, outLinks and ranks in the order listName
+ * lists them) to tableName. listName must already be written; the table
+ * is only used while listName is unchanged.
+ */
+void writeRankTable(char *tableName, char *listName, int n, char **names,
+                    int *outLinks, double *ranks);
+// maps tableName, NULL if it is missing, corrupt or older than listName
+RankTable loadRankTable(char *tableName, char *listName);
+void freeRankTable(RankTable);
+// number of URLs
+int rankTableSize(RankTable);
+// position of url in the list, or -1
+int rankTableFind(RankTable, char *url);
+char *rankTableURL(RankTable, int pos);
+int rankTableOutLinks(RankTable, int pos);
+double rankTableRank(RankTable, int pos);
+
+#endif
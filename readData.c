@@ -15,6 +15,10 @@
 #include "BSTree.h"
 #include "readData.h"
 #include "mystring.h"
+#include "tokeniser.h"
+#include "hashMap.h"
+#include "stats.h"
+#include "pageArchive.h"
 
 #define SEEN_ONCE       1
 #define SEEN_TWICE      2
@@ -26,6 +30,12 @@
 #define CHAR_LEN        1
 #define TRUE			1
 #define FALSE			0
+#define MAX_PATH		1024
+#define PAGE_SUFFIX		".txt"
+#define COLLECTION_FILE	"collection.txt"
+
+// pages of the collection getCollection read, or NULL
+static PageArchive collectionArchive = NULL;
 
 /* Trims leading and ending spaces 
  * Written by jas for 1521 mymysh.c 18s2
@@ -61,6 +71,7 @@ char **tokenise(char *str, char *sep)
    // allocate array for argv strings
    char **strings = malloc((n+1)*sizeof(char *));
    assert(strings != NULL);
+   STATS_ADD(STAT_TOKENS, n);
    // now tokenise and fill array
    tmp = mystrdup(str);
    char *next; int i = 0;
@@ -137,24 +148,58 @@ char *normalise(char *str)
 }
 
 
-/* Creates a set of all URLs in collection.txt. */
+/* Creates a set of all URLs in collection.txt, and maps the archive of
+ * the working directory for readPage and spaceRequired.
+ */
 Set getCollection()
 {
-	FILE *file = fopen("collection.txt", "r");
+	closeArchive(collectionArchive);
+	collectionArchive = openArchive(ARCHIVE_FILE, COLLECTION_FILE);
+	FILE *file = statsFopen(COLLECTION_FILE, "r");
 	if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+	Set URLList = readCollection(file);
+	fclose(file);
+	return URLList;
+}
 
+
+/* Creates a set of the URLs in an open collection file. */
+Set readCollection(FILE *file)
+{
 	// Gets every URL and adds it to set.
 	Set URLList = newSet();
 	char URL[URL_LENGTH];
-	while (fscanf(file, "%s ", URL) != EOF) {
+	while (fscanf(file, "%54s ", URL) != EOF) {
 		trim(URL);
 		insertInto(URLList, URL);
 	}
-	fclose(file);
+	STATS_ADD(STAT_BYTES, ftell(file));
 	return URLList;
 }
 
 
+/* Opens the page fileName (dir/URL.txt) for reading: from archive (may
+ * be NULL) if the URL is packed in it, unless the archive watches its
+ * pages and the file has changed since, otherwise from the file. NULL
+ * if neither has it.
+ */
+FILE *openPage(PageArchive archive, char *fileName)
+{
+	char URL[MAX_PATH];
+	char *base = strrchr(fileName, '/');
+	base = base == NULL ? fileName : base + 1;
+	int len = strlen(base), suffix = strlen(PAGE_SUFFIX);
+	if (archive != NULL && len > suffix && len < MAX_PATH
+	&& strcmp(base + len - suffix, PAGE_SUFFIX) == 0) {
+		snprintf(URL, MAX_PATH, "%.*s", len - suffix, base);
+		int id = archiveFind(archive, URL);
+		if (id >= 0 && archivePageCurrent(archive, id, fileName))
+			return archivePage(archive, id);
+	}
+	return statsFopen(fileName, "r");
+}
+
+
 /* Places section 1 and section 2 of fileName into urls & texts */
 void readPage(char *urls, char *text, char *fileName)
 {
@@ -162,8 +207,8 @@ void readPage(char *urls, char *text, char *fileName)
 
 	int seen = 0;
 	char line[MAX_LINE] = {0};
-	FILE *page = fopen(fileName, "r");
-	while (fgets(line, MAX_LINE, page) != NULL) {
+	FILE *page = openPage(collectionArchive, fileName);
+	while (statsFgets(line, MAX_LINE, page) != NULL) {
 		// Increments seen at every start tag.
 		if (strncmp(line, "#start Section-1", START_TAG_LEN) == 0 
 		|| strncmp(line, "#start Section-2", START_TAG_LEN) == 0) { seen++; continue; }
@@ -182,15 +227,59 @@ void readPage(char *urls, char *text, char *fileName)
 }
 
 
+/* Appends line to the growing string *str of *len chars. */
+static void appendLine(char **str, int *len, int *cap, char *line)
+{
+	int n = strlen(line);
+	if (*len + n + NULL_TERM_SPACE > *cap) {
+		while (*len + n + NULL_TERM_SPACE > *cap) *cap *= 2;
+		*str = realloc(*str, *cap);
+		assert(*str != NULL);
+	}
+	memcpy(*str + *len, line, n + NULL_TERM_SPACE);
+	*len += n;
+}
+
+
+/* readPage in one pass over the file: section 1 and 2 of fileName (from
+ * archive if it has the page) in new strings *urls and *text, which the
+ * caller frees. Returns FALSE if the page cannot be opened.
+ */
+int readPageSections(PageArchive archive, char *fileName, char **urls, char **text)
+{
+	FILE *page = openPage(archive, fileName);
+	if (page == NULL) return FALSE;
+	int seen = 0, i;
+	int urlLen = 0, urlCap = MAX_LINE, textLen = 0, textCap = MAX_LINE;
+	char line[MAX_LINE] = {0};
+	*urls = calloc(urlCap, sizeof(char));
+	*text = calloc(textCap, sizeof(char));
+	assert(*urls != NULL && *text != NULL);
+	while (statsFgets(line, MAX_LINE, page) != NULL) {
+		if (strncmp(line, "#start Section-1", START_TAG_LEN) == 0 
+		|| strncmp(line, "#start Section-2", START_TAG_LEN) == 0) { seen++; continue; }
+		if (strncmp(line, "#end Section-1", END_TAG_LEN) == 0
+		|| strncmp(line, "#end Section-2", END_TAG_LEN) == 0
+		|| strncmp(line, "\n", CHAR_LEN) == 0) continue;
+		if (seen == SEEN_ONCE) appendLine(urls, &urlLen, &urlCap, line);
+		if (seen == SEEN_TWICE) appendLine(text, &textLen, &textCap, line);
+	}
+	for (i = 0; i < textLen; i++) if ((*text)[i] == '\n') (*text)[i] = ' ';
+	for (i = 0; i < urlLen; i++) if ((*urls)[i] == '\n') (*urls)[i] = ' ';
+	fclose(page);
+	return TRUE;
+}
+
+
 /* Calculates space required for section 1 and 2 */
 void spaceRequired(char *fileName, int *url_size, int *text_size)
 {
 	int seen = 0;
 	char line[MAX_LINE] = {0};
-	FILE *page = fopen(fileName, "r");
+	FILE *page = openPage(collectionArchive, fileName);
 	*url_size = NULL_TERM_SPACE;
 	*text_size = NULL_TERM_SPACE;
-	while (fgets(line, MAX_LINE, page) != NULL) {
+	while (statsFgets(line, MAX_LINE, page) != NULL) {
 		if (strncmp(line, "#start Section-1", START_TAG_LEN) == 0 
 		|| strncmp(line, "#start Section-2", START_TAG_LEN) == 0) { seen++; continue; }
 		if (strncmp(line, "#end Section-1", END_TAG_LEN) == 0
@@ -205,11 +294,34 @@ void spaceRequired(char *fileName, int *url_size, int *text_size)
 }
 
 
-/* Creates a list of url for each word found in urls. */
-BSTree getInvertedList(Set URLList)
+/* Counts word in URL number page for the stats; seen maps each word to
+ * the last page it was counted for.
+ */
+static void countPosting(HashMap seen, char *word, int page, int *terms, int *postings)
+{
+	int last = hashMapGet(seen, word);
+	if (last == page) return;
+	if (last == NOT_FOUND) (*terms)++;
+	(*postings)++;
+	hashMapPut(seen, word, page);
+}
+
+/* Inverted index of the pages in URLList, each word passed through
+ * analyser first (NULL for none). Words it drops as stop words are not
+ * indexed. The counts are only kept when stats is not NULL.
+ */
+BSTree getInvertedList(Set URLList, Analyser analyser, IndexStats *stats)
 {
 	BSTree invList = newBSTree();
+	TokenBuffer words = newTokenBuffer();
 	char fileName[URL_LENGTH] = {0};
+	HashMap rawSeen = NULL, seen = NULL;
+	if (stats != NULL) {
+		rawSeen = newHashMap(URLList->nelems);
+		seen = newHashMap(URLList->nelems);
+		memset(stats, 0, sizeof(IndexStats));
+	}
+	int page = 0;
 
 	// Iterate through set to get urls.
 	SetNode curr = URLList->elems;
@@ -222,18 +334,23 @@ BSTree getInvertedList(Set URLList)
 		char *text = calloc(text_size, sizeof(char));
 		readPage(urls, text, fileName);
 
-		char *dump = text; // Keeps pointer to text to free because strsep ruins it.
-		char *found;
 		// For every word in every url.
-		while((found = strsep(&text, " ")) != NULL) {
-			char *word = normalise(found);
-			if (strcmp(word, "") != 0)
-				invList = BSTreeInsert(invList, word, curr->val);
-			free(word);
+		int i, nWords = tokeniseText(words, text);
+		for (i = 0; i < nWords; i++) {
+			char *word = words->text + words->start[i];
+			if (words->len[i] == 0) continue;
+			if (stats != NULL) countPosting(rawSeen, word, page, &stats->rawTerms, &stats->rawPostings);
+			if (analyseWord(analyser, word, words->len[i]) == 0) continue;
+			if (stats != NULL) countPosting(seen, word, page, &stats->terms, &stats->postings);
+			invList = BSTreeInsert(invList, word, curr->val);
 		}
-		free(dump); free(urls); free(text); free(found);
+		free(urls); free(text);
 		curr = curr->next;
+		page++;
 	}
+	freeTokenBuffer(words);
+	disposeHashMap(rawSeen);
+	disposeHashMap(seen);
 	return invList;
 }
 
@@ -241,7 +358,7 @@ BSTree getInvertedList(Set URLList)
 int linkAlreadyExists(Link start, char *name) {
 	Link curr = start;
 	for (; curr != NULL; curr = curr->next) {
-		if (strcmp(curr->URLName, name) == 0) return TRUE;
+		if (STATS_STRCMP(curr->URLName, name) == 0) return TRUE;
 	}
 	return FALSE;
 }
@@ -271,7 +388,7 @@ Graph getGraph(Set URLList)
 			char **urlsTokenised = tokenise(urls, " ");
 			for (j = 0; urlsTokenised[j] != NULL; j++) {
 				// dont add an outlink to itself, no loops
-				if (strcmp(g->listOfUrls[i]->URLName, urlsTokenised[j]) == 0) continue;
+				if (STATS_STRCMP(g->listOfUrls[i]->URLName, urlsTokenised[j]) == 0) continue;
 				// dont add another link that already exists, no parallel edges
 				if (linkAlreadyExists(g->listOfUrls[i]->outLink, urlsTokenised[j])) continue;
 				insertOutLinks(g->listOfUrls[i], urlsTokenised[j]);
@@ -289,7 +406,7 @@ Graph getGraph(Set URLList)
 		for (Link curr = g->listOfUrls[i]->outLink; curr != NULL; curr = curr->next) {
 			// set the outlink pointer to point to an actual node
 			for (j = 0; j < g->numURLs; j++) {
-				if (strcmp(g->listOfUrls[j]->URLName, curr->URLName) == 0) {
+				if (STATS_STRCMP(g->listOfUrls[j]->URLName, curr->URLName) == 0) {
 					curr->URLPointer = g->listOfUrls[j];
 				}
 			}
@@ -302,10 +419,10 @@ Graph getGraph(Set URLList)
 		// go through all the other nodes
 		for (j = 0; j < g->numURLs; j++) {
 			// go through their outlinks
-			if (strcmp(g->listOfUrls[i]->URLName, g->listOfUrls[j]->URLName) == 0) continue;
+			if (STATS_STRCMP(g->listOfUrls[i]->URLName, g->listOfUrls[j]->URLName) == 0) continue;
 			for (Link curr = g->listOfUrls[j]->outLink; curr != NULL; curr = curr->next) {
 				// if they have an outlink to the og node, there should be an outlink for the og node
-				if (strcmp(g->listOfUrls[i]->URLName, curr->URLName) == 0) {
+				if (STATS_STRCMP(g->listOfUrls[i]->URLName, curr->URLName) == 0) {
 					insertInLinks(g->listOfUrls[i], g->listOfUrls[j]);
 					g->listOfUrls[i]->numInLinks++;
 				}
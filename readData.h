@@ -7,9 +7,12 @@
  * Header file for readData.c.
  */
 
+#include <stdio.h>
 #include "set.h"
 #include "graph.h"
 #include "BSTree.h"
+#include "analyser.h"
+#include "pageArchive.h"
 
 #ifndef READDATA_H
 #define READDATA_H
@@ -18,9 +21,19 @@ void trim(char *str);
 char **tokenise(char *str, char *sep);
 char *normalise(char *str);
 Set getCollection();
+Set readCollection(FILE *file);
+// a page from archive (see pageArchive.h, may be NULL), or else its file
+FILE *openPage(PageArchive archive, char *fileName);
 void readPage(char *urls, char *text, char *fileName);
+int readPageSections(PageArchive archive, char *fileName, char **urls, char **text);
 void spaceRequired(char *fileName, int *url_size, int *text_size);
-BSTree getInvertedList(Set URLList);
+// index size before and after analysis, filled by getInvertedList if asked
+typedef struct indexStats {
+	int rawTerms, rawPostings;	// distinct words, (word, URL) pairs
+	int terms, postings;		// the same after analysis
+} IndexStats;
+
+BSTree getInvertedList(Set URLList, Analyser analyser, IndexStats *stats);
 Graph getGraph(Set URLList);
 void freeTokens(char **toks);
 void freeLinks(Link head);
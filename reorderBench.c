@@ -0,0 +1,197 @@
+/* reorderBench.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Measures what URL reordering does to the PageRank inner loop.
+ * Builds a synthetic web graph (pages grouped into sites, most links
+ * staying inside a site, the rest going to popular pages) and shuffles
+ * the IDs the way lexicographic URL names would. Then, for each
+ * reordering, times a fixed number of iterations and counts cache
+ * misses with perf_event_open when the kernel allows it.
+ *
+ * Usage: ./reorderBench [nURLs] [iterations] [seed]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <unistd.h>
+#include "linkGraph.h"
+#include "rng.h"
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define DEFAULT_URLS    1000000
+#define DEFAULT_ITERS   10
+#define DEFAULT_SEED    42
+#define SITE_SIZE       64
+#define MAX_OUTLINKS    40
+#define LOCAL_PERCENT   80
+#define DAMPING         0.85
+#define NO_COUNTER      -1
+
+static unsigned long long rngState;
+
+
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+
+/* Generates the site-structured graph, then hides the structure behind
+ * a random relabelling. Returns the number of edges.
+ */
+static long generateGraph(int n, int **srcOut, int **dstOut)
+{
+    long cap = (long)n * MAX_OUTLINKS / 4 + 1, e = 0;
+    int *src = malloc(cap * sizeof(int));
+    int *dst = malloc(cap * sizeof(int));
+    int *label = malloc(n * sizeof(int));
+    assert(src != NULL && dst != NULL && label != NULL);
+    int u, k;
+    for (u = 0; u < n; u++) label[u] = u;
+    for (u = n - 1; u > 0; u--) {
+        int r = nextRandom(&rngState) % (u + 1);
+        int tmp = label[u]; label[u] = label[r]; label[r] = tmp;
+    }
+    for (u = 0; u < n; u++) {
+        // heavy tailed out-degree between 1 and MAX_OUTLINKS
+        double skew = uniform(&rngState) * uniform(&rngState) * uniform(&rngState);
+        int deg = 1 + (int)((MAX_OUTLINKS - 1) * skew);
+        int site = u / SITE_SIZE * SITE_SIZE;
+        for (k = 0; k < deg; k++) {
+            int v;
+            if ((int)(nextRandom(&rngState) % 100) < LOCAL_PERCENT) {
+                v = site + nextRandom(&rngState) % SITE_SIZE;
+                if (v >= n) v = n - 1;
+            } else {
+                // low IDs are the popular pages
+                double x = uniform(&rngState);
+                v = (int)(x * x * x * n);
+            }
+            if (v == u) continue;
+            if (e == cap) {
+                cap *= 2;
+                src = realloc(src, cap * sizeof(int));
+                dst = realloc(dst, cap * sizeof(int));
+                assert(src != NULL && dst != NULL);
+            }
+            src[e] = label[u]; dst[e] = label[v]; e++;
+        }
+    }
+    // drop parallel edges: sort by (src, dst) with a two pass radix
+    int *count = calloc(n + 1, sizeof(int));
+    int *tmpSrc = malloc(e * sizeof(int)), *tmpDst = malloc(e * sizeof(int));
+    assert(count != NULL && tmpSrc != NULL && tmpDst != NULL);
+    long i;
+    for (i = 0; i < e; i++) count[dst[i] + 1]++;
+    for (u = 0; u < n; u++) count[u + 1] += count[u];
+    for (i = 0; i < e; i++) { long p = count[dst[i]]++; tmpSrc[p] = src[i]; tmpDst[p] = dst[i]; }
+    memset(count, 0, (n + 1) * sizeof(int));
+    for (i = 0; i < e; i++) count[tmpSrc[i] + 1]++;
+    for (u = 0; u < n; u++) count[u + 1] += count[u];
+    for (i = 0; i < e; i++) { long p = count[tmpSrc[i]]++; src[p] = tmpSrc[i]; dst[p] = tmpDst[i]; }
+    long m = 0;
+    for (i = 0; i < e; i++) {
+        if (m > 0 && src[m - 1] == src[i] && dst[m - 1] == dst[i]) continue;
+        src[m] = src[i]; dst[m] = dst[i]; m++;
+    }
+    free(count); free(tmpSrc); free(tmpDst); free(label);
+    *srcOut = src; *dstOut = dst;
+    return m;
+}
+
+
+// opens a cache miss counter for this process, or NO_COUNTER
+static int openMissCounter()
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return NO_COUNTER;
+#endif
+}
+
+
+static void startCounter(int fd)
+{
+#ifdef __linux__
+    if (fd == NO_COUNTER) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+
+static long long stopCounter(int fd)
+{
+    long long misses = NO_COUNTER;
+#ifdef __linux__
+    if (fd == NO_COUNTER) return NO_COUNTER;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &misses, sizeof(misses)) != sizeof(misses)) misses = NO_COUNTER;
+#endif
+    return misses;
+}
+
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : DEFAULT_URLS;
+    int iters = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERS;
+    rngState = seedRandom(argc > 3 ? strtoull(argv[3], NULL, 10) : DEFAULT_SEED);
+    if (n <= 0 || iters <= 0) {
+        printf("Usage: ./reorderBench [nURLs] [iterations] [seed]\n");
+        exit(EXIT_FAILURE);
+    }
+    int *src, *dst;
+    long m = generateGraph(n, &src, &dst);
+    printf("urls %d edges %ld iterations %d\n", n, m, iters);
+    printf("%-8s %12s %14s %16s %14s\n", "order", "reorder_ms", "ms_per_iter", "cache_misses", "misses_per_edge");
+
+    char *names[] = { "none", "degree", "rcm" };
+    int methods[] = { REORDER_NONE, REORDER_DEGREE, REORDER_RCM };
+    double *ranks = malloc((n + 1) * sizeof(double));
+    assert(ranks != NULL);
+    int fd = openMissCounter();
+    int k;
+    for (k = 0; k < 3; k++) {
+        LinkGraph g = newLinkGraph(n, m, src, dst);
+        double t0 = now();
+        reorderLinkGraph(g, methods[k]);
+        double t1 = now();
+        startCounter(fd);
+        // diffPR of 0 forces exactly iters iterations
+        linkGraphPageRank(g, DAMPING, 0, iters, ranks, NULL);
+        long long misses = stopCounter(fd);
+        double t2 = now();
+        if (misses == NO_COUNTER)
+            printf("%-8s %12.1f %14.2f %16s %14s\n", names[k], (t1 - t0) * 1e3,
+                   (t2 - t1) * 1e3 / iters, "n/a", "n/a");
+        else
+            printf("%-8s %12.1f %14.2f %16lld %14.3f\n", names[k], (t1 - t0) * 1e3,
+                   (t2 - t1) * 1e3 / iters, misses, (double)misses / ((double)m * iters));
+        freeLinkGraph(g);
+    }
+    if (fd != NO_COUNTER) close(fd);
+    free(ranks); free(src); free(dst);
+    return 0;
+}
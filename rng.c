@@ -0,0 +1,39 @@
+/* rng.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Implementation of rng.h.
+ */
+
+#include "rng.h"
+
+#define MULTIPLIER  2685821657736338717ULL
+#define TWO_TO_53   9007199254740992.0
+
+
+unsigned long long seedRandom(unsigned long long seed)
+{
+    return seed * 2 + 1;
+}
+
+
+unsigned long long nextRandom(unsigned long long *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * MULTIPLIER;
+}
+
+
+double uniform(unsigned long long *state)
+{
+    return (nextRandom(state) >> 11) * (1.0 / TWO_TO_53);
+}
+
+
+double uniformOpen(unsigned long long *state)
+{
+    return ((nextRandom(state) >> 11) + 0.5) * (1.0 / TWO_TO_53);
+}
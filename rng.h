@@ -0,0 +1,23 @@
+/* rng.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * The seeded random numbers of the generators, benchmarks and checks:
+ * xorshift64* on a state the caller keeps, so a given seed gives the
+ * same numbers on every platform and no two users disturb each other
+ * (or anyone's use of rand()).
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+// a state from any seed; xorshift would stay at 0 forever
+unsigned long long seedRandom(unsigned long long seed);
+unsigned long long nextRandom(unsigned long long *state);
+// uniform double in [0, 1)
+double uniform(unsigned long long *state);
+// uniform double in (0, 1), safe to take logs or negative powers of
+double uniformOpen(unsigned long long *state);
+
+#endif
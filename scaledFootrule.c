@@ -3,6 +3,43 @@
  * Written by Selina (z5208109) & Yasmin (z5207093)
  * Group: duckduckgo
  * Start Date: 10/10/18
+ *
+ * USAGE: ./scaledFootrule [OPTIONS] rankFile ...
+ *
+ * Reads the rank files into lists of URL numbers and merges them with
+ * the rank aggregation library (rankAgg.h).
+ *
+ * OPTIONS (anywhere among the rank files):
+ *  --mode=M         exact (default) solves the footrule assignment;
+ *                   median, borda and markov (MC4) are fast
+ *                   approximations, see aggregate.c.
+ *  --window=W       markov compares each place of a list with W others
+ *                   (0 compares every pair).
+ *  --solver=S       exact mode solver: hungarian (default), auction or
+ *                   banded (only positions near each URL's median,
+ *                   O(n * band) memory).
+ *  --eps=E          auction bid increment; the result is within
+ *                   numURLs * E of the optimum.
+ *  --threads=T      auction bidding threads.
+ *  --band=W         banded starts with W positions either side of each
+ *                   median and doubles W until an assignment fits and
+ *                   its potentials prove it optimal.
+ *  --top=K          only place the best K positions: every other URL
+ *                   goes to a shared tail bucket costing what its best
+ *                   position after K would, and only K URLs are
+ *                   printed. The exact mode then solves a K x n
+ *                   assignment, O(K^2 * n) time and O(K * n) memory,
+ *                   with its own solver: it cannot be combined with
+ *                   --solver=auction, --solver=banded or --warm.
+ *  --warm=FILE      exact Hungarian mode: resume from the solve saved in
+ *                   FILE by an earlier run and only re-solve the URLs
+ *                   whose positions changed, then save this solve
+ *                   there. Without a usable FILE it solves from scratch.
+ *  --report[=exact] print the mode, its scaled footrule distance and
+ *                   time to stderr; with =exact also solve the exact
+ *                   assignment and print the optimum and the gap.
+ * The first line of output is always the scaled footrule distance of
+ * the order printed (with --top, of the top K plus the tail bucket).
  */
 
 
@@ -10,542 +47,308 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <limits.h>
-#include "set.h"
+#include <assert.h>
 #include "readData.h"
 #include "mystring.h"
-#include <math.h>
+#include "hashMap.h"
+#include "stats.h"
+#include "rankAgg.h"
 
 #define URL_LENGTH 55
-#define MIN(X, Y)  ( (X < Y) ? X : Y)  
-#define MAX(X, Y)  ( (X > Y) ? X : Y)  
 #define TRUE 1
 #define FALSE 0
-#define SHIFT       1
-#define INTERSECTING_LINE 2
-#define EMPTY -1.0
-
-
-struct URLRank {
-    char  *fileName;
-    double posData[2][10];
-    int finalPos;
+#define INIT_URLS   64
+#define MODE_FLAG   "--mode="
+#define WINDOW_FLAG "--window="
+#define REPORT_FLAG "--report"
+#define EXACT       "exact"
+#define SOLVER_FLAG "--solver="
+#define EPS_FLAG    "--eps="
+#define THREADS_FLAG "--threads="
+#define BAND_FLAG   "--band="
+#define TOP_FLAG    "--top="
+#define WARM_FLAG   "--warm="
+#define WARM_MAGIC  0x57524653  // "SFRW"
+
+// the rank files as lists of URL numbers
+struct rankLists {
+    int    nLists;
+    int  **ids;
+    int   *len;
+    int    nURLs;
+    char **names;   // URL of each number, in order of first appearance
 };
 
-typedef struct URLRank *rankFP;
+typedef struct rankLists *RankLists;
 
 
-/* THE HUNGARIAN ALGORITHM:
- * 1. Represent cost matrix in an n x n 2d array
- *    - Rows: urls in set
- *    - Cols: possible positions
- * 2. Calculate the footrule distance for each [row][col]
- * 3. Subtract row minima
- *    - Subtract minima from all elements in row.
- *    - This gives at least 1 0 on each row.
- * 4. Subtract col minima
- *    - Subtract minima from all elements in col.
- *    - Gives at least 1 0 on each col.
- * 5. Count number of lines L required to cover all the 0s.
- *    - If L == n, optimal sol found.
- *    - else, move to next step.
- * 6. Find smallest number from uncovered area.
- * 7. Subtract this number from all UNCOVERED ROWS.
- * 8. Add new smallest number to COVERED COLS.
- * 9. Go back to step 5 and repeat.
+/* Reads the rank files into lists of URL numbers. URLs are numbered in
+ * order of first appearance through a hash map, so the whole read is
+ * linear in the input. The nSeed seed names, if any, are numbered first.
  */
-
-// print matrix out
-void showMatrix(double **matrix, int n)
-{
-    int i, j;
-    for (i = 0; i < n; i++) {
-        for (j = 0; j < n; j++)
-            printf("%.20f ", matrix[i][j]);
-        printf("\n");
-    }
-    printf("\n");
-}
-
-
-/* Finds minimum from each row and subtracts from all elements. */
-void rowReduce(double **matrix, int size)
-{
-    int row, col;
-    for (row = 0; row < size; row++) {
-        double min = INT_MAX;
-        // Find min element in row.
-        for (col = 0; col < size; col++)
-            min = MIN(min, matrix[row][col]);
-        // Subtracts min from all elements.
-        for (col = 0; col < size; col++)
-            matrix[row][col] -= min;
-    }
-}
-
-
-/* Finds minimum from each col and subtracts from all elements. */
-void colReduce(double **matrix, int size)
-{
-    int row, col;
-    for (col = 0; col < size; col++) {
-        double min = INT_MAX;
-        // Find min element in row.
-        for (row = 0; row < size; row++)
-            min = MIN(min, matrix[row][col]);
-        // Subtracts min from all elements.
-        for (row = 0; row < size; row++)
-            matrix[row][col] -= min;
-    }
-}
-
-
-/* Calculates the scaled foot rule distance. */
-double calcSFRDist(double pos[2][10], int newPos, double unionSize)
-{
-    double sum = 0;
-    int i = 0;
-    // scaled foot rule distance is the sum of the difference between their 
-    // original position and the position the're moved to
-    for (i = 0; pos[0][i] != EMPTY && pos[1][i] != EMPTY; i++) {
-        sum = sum + fabs((pos[0][i]/pos[1][i]) - (newPos/unionSize));
-    }
-    return fabs(sum);
-}
-
-
-// read all URLS into a set
-Set GetAllUrls(int nFiles, char **fileNames)
-{
-    Set URLs = newSet();
-    int i = 0;
-    for (i = 1; i < nFiles; i++) {
-        FILE *file = fopen(fileNames[i], "r");
-        char line[URL_LENGTH] = {0};
-        while (fgets(line, URL_LENGTH, file) != NULL) {
-            trim(line);
-            insertInto(URLs, line);
-        }
-        fclose(file);
-    }
-    return URLs;
-}
-
-
-// Check if the URL already exists in the array
-rankFP found(rankFP *array, int nURLs, char *URLName)
+void readRankFiles(char **fileNames, int nFiles, char **seed, int nSeed,
+                   RankLists lists)
 {
     int i;
-    for (i = 0; i < nURLs; i++) {
-        if (strcmp(array[i]->fileName, URLName) == 0) return array[i];
-    }
-    return NULL;
-}
-
-
-// gets the number of lines in a file - the number of URLs in each ordered list
-double linesInFile(char *fileName)
-{
-    FILE *file = fopen(fileName, "r");
-    char line[URL_LENGTH] = {0};
-    double i = 0.0;
-    while (fgets(line, URL_LENGTH, file) != NULL) i++;
-    fclose(file);
-    return i;
-}
-
-
-// insert new positional data into URL
-void insertRankData(rankFP URL, int pos, double nURLs)
-{
-    int i;
-    for (i = 0; URL->posData[0][i] != EMPTY && URL->posData[1][i] != EMPTY; i++);
-    URL->posData[0][i] = pos;
-    URL->posData[1][i] = nURLs;
-}
-
-
-// create new URL node
-rankFP newUrlRank(char *name, int pos, double fileSize)
-{
-    rankFP newFP = calloc(1, sizeof(struct URLRank));
-    int i = 0;
-    for (i = 0; i < 10; i++) {
-        newFP->posData[0][i] = EMPTY;
-        newFP->posData[1][i] = EMPTY;
+    int capURLs = INIT_URLS + nSeed;
+    HashMap ids = newHashMap(capURLs);
+    lists->nLists = nFiles;
+    lists->nURLs = 0;
+    lists->ids = malloc(nFiles * sizeof(int *));
+    lists->len = malloc(nFiles * sizeof(int));
+    lists->names = malloc(capURLs * sizeof(char *));
+    assert(lists->ids != NULL && lists->len != NULL && lists->names != NULL);
+    for (i = 0; i < nSeed; i++) {
+        lists->names[lists->nURLs++] = mystrdup(seed[i]);
+        hashMapPut(ids, seed[i], i);
     }
-    insertRankData(newFP, pos, fileSize);
-    newFP->fileName = mystrdup(name);
-    newFP->finalPos = -1;
-    return newFP;
-}
-
-
-// reads Rank Files in and constructs an ADT that holds URLs and their 
-// positions in the rank files
-void buildRankADT(rankFP *array, char **fileNames, int nFiles)
-{
-    int i;
-    int nURLs = 0;
-    for (i = 1; i < nFiles; i++) {
-        double nLines = linesInFile(fileNames[i]);
-        FILE *file = fopen(fileNames[i], "r");
+    for (i = 0; i < nFiles; i++) {
+        FILE *file = statsFopen(fileNames[i], "r");
+        if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
         char line[URL_LENGTH] = {0};
-        int pos = 1; // position is indexed starting at 1, not 0
-        rankFP curr = NULL;
-        while (fgets(line, URL_LENGTH, file) != NULL) {
+        // IDs of the URLs in the current file, in order
+        int nLines = 0, capLines = INIT_URLS;
+        int *lineIds = malloc(capLines * sizeof(int));
+        assert(lineIds != NULL);
+        while (statsFgets(line, URL_LENGTH, file) != NULL) {
             trim(line);
-            curr = found(array, nURLs, line);
-            if (curr != NULL) {
-                insertRankData(curr, pos, nLines);
-            } else {
-                array[nURLs] = newUrlRank(line, pos, nLines);
-                nURLs++;
+            int id = hashMapGet(ids, line);
+            if (id == NOT_FOUND) {
+                if (lists->nURLs == capURLs) {
+                    capURLs *= 2;
+                    lists->names = realloc(lists->names, capURLs * sizeof(char *));
+                    assert(lists->names != NULL);
+                }
+                id = lists->nURLs++;
+                lists->names[id] = mystrdup(line);
+                hashMapPut(ids, line, id);
+            }
+            if (nLines == capLines) {
+                capLines *= 2;
+                lineIds = realloc(lineIds, capLines * sizeof(int));
+                assert(lineIds != NULL);
             }
-            pos++;
+            lineIds[nLines++] = id;
         }
         fclose(file);
+        lists->ids[i] = lineIds;
+        lists->len[i] = nLines;
     }
+    disposeHashMap(ids);
 }
 
 
-/* Sets the zeroCount[row][col] to all 1s. */
-void setLine(int **coverMatrix, int numURLs, int row, int col)
+void freeLists(RankLists lists)
 {
     int i;
-    // If want to set a column to 1.
-    if (row == -1) {
-        for (i = 0; i < numURLs; i++)
-            coverMatrix[i][col]++;
-    // If want to set a row to 1.
-    } else if (col == -1) {
-        for (i = 0; i < numURLs; i++)
-            coverMatrix[row][i]++;
-    }
-}
-
-
-/* Checks if matrix is all 0s. */
-int allZero(int **matrix, int nRows, int nCols)
-{
-    int i, j;
-    for (i = 0; i < nRows; i++) {
-        for (j = 0; j < nCols; j++) {
-            if (matrix[i][j] != 0)
-                return FALSE;
-        }
-    }
-    return TRUE;
+    for (i = 0; i < lists->nLists; i++) free(lists->ids[i]);
+    for (i = 0; i < lists->nURLs; i++) free(lists->names[i]);
+    free(lists->ids);
+    free(lists->len);
+    free(lists->names);
 }
 
 
-/* Gets max num in a 2d array */
-int getMax(int **matrix, int nRows, int nCols, int *index)
+/* Reads the URL names and aggregator state saved by writeWarm. Returns
+ * the names (nNames of them) or NULL if the file is missing or invalid.
+ */
+char **readWarm(char *fileName, RankAgg agg, int *nNames)
 {
-    int i, j;
-    int max = 0;
-    // Goes through rows & cols to get row/col that has the most 0s.
-    for (i = 0; i < nRows; i++) {
-        for (j = 0; j < nCols; j++) {
-            if (matrix[i][j] > max) {
-                max = matrix[i][j];
-                *index = (i * nCols) + j;
-            }
-        }
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+    int magic, n, i, len, ok;
+    ok = fread(&magic, sizeof(int), 1, file) == 1 && magic == WARM_MAGIC;
+    ok = ok && fread(&n, sizeof(int), 1, file) == 1 && n > 0;
+    char **names = ok ? calloc(n, sizeof(char *)) : NULL;
+    for (i = 0; ok && i < n; i++) {
+        ok = fread(&len, sizeof(int), 1, file) == 1 && len >= 0 && len < URL_LENGTH;
+        if (!ok) break;
+        names[i] = calloc(len + 1, sizeof(char));
+        assert(names[i] != NULL);
+        ok = fread(names[i], sizeof(char), len, file) == len;
     }
-    return max;
-}
-
-
-/* Creates a 2d array that count zeroes in each row and col. */
-int **countZeroes(double **matrix, int numURLs)
-{
-    int row, col;
-    // double zero = 0.0;
-    int **zeroCount = calloc(2, sizeof(int *));
-    for (row = 0; row < 2; row++)
-        zeroCount[row] = calloc(numURLs, sizeof(int));
-    // Count zeroes in the matrix.
-    for (row = 0; row < numURLs; row++) {
-        for (col = 0; col < numURLs; col++) {
-            if (matrix[row][col] != 0) continue;
-            zeroCount[0][row]++;
-            zeroCount[1][col]++;
-        }
+    ok = ok && readAggState(agg, file);
+    fclose(file);
+    if (ok) { *nNames = n; return names; }
+    if (names != NULL) {
+        for (i = 0; i < n; i++) free(names[i]);
+        free(names);
     }
-    return zeroCount;
+    return NULL;
 }
 
 
-/* Counts min # of lines needed to cover all 0s. */
-int numLinesToCoverZeroes(int **coverMatrix, int **zeroCount, double **cost, int numURLs)
+// saves the URL names and the aggregator state for the next run
+void writeWarm(char *fileName, RankAgg agg, RankLists lists)
 {
-    int i;
-    int max = 0;
-    int index, zeroRow, zeroCol;
-    int lines = 0;
-    // While not all zeroes have been covered.
-    while (!allZero(zeroCount, 2, numURLs)) {
-        max = getMax(zeroCount, 2, numURLs, &index);
-        // Gets row and col of zeroCount.
-        zeroRow = index / numURLs;
-        zeroCol = index % numURLs;
-        // Subtract # of zeroes crossed out from covered rows & cols.
-        zeroCount[zeroRow][zeroCol] -= max;
-        for (i = 0; i < numURLs; i++) {
-            if (zeroRow == 0 && cost[zeroCol][i] == 0.0) {
-                zeroCount[1][i]--;
-                setLine(coverMatrix, numURLs, zeroCol, -1);
-            }
-            if (zeroRow == 1 && cost[i][zeroCol] == 0.0) {
-                zeroCount[1][i]--;
-                setLine(coverMatrix, numURLs, -1, zeroCol);
-            }
-        }
-        lines++;
+    FILE *file = fopen(fileName, "wb");
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    int magic = WARM_MAGIC, i;
+    fwrite(&magic, sizeof(int), 1, file);
+    fwrite(&lists->nURLs, sizeof(int), 1, file);
+    for (i = 0; i < lists->nURLs; i++) {
+        int len = strlen(lists->names[i]);
+        fwrite(&len, sizeof(int), 1, file);
+        fwrite(lists->names[i], sizeof(char), len, file);
     }
-
-
-    return lines;
+    writeAggState(agg, file);
+    fclose(file);
 }
 
 
-/* Row reduces all uncovered elements by min. */
-void rowReduceUncovered(int **coverMatrix, double min, double **cost, int numURLs)
-{
-    int i, j;
-    // Subtract min from all uncovered elements.
-    for (i = 0; i < numURLs; i++) {
-        for (j = 0; j < numURLs; j++) {
-            // If not covered by a line.
-            if (!coverMatrix[i][j])
-                cost[i][j] -= min;
-        }
-    }
-}
-
-/* Adds min to all covered columns */
-void colAddCovered(int **coverMatrix, double min, double **cost, int numURLs) 
+// TRUE if every URL number below nSeed is in some list
+int seedsUsed(RankLists lists, int nSeed)
 {
-    int i, j;
-    // Add min to all elements that have an intersecting line.
-    for (i = 0; i < numURLs; i++) {
-        for (j = 0; j < numURLs; j++) {
-            // If covered by 2 lines.
-            if (coverMatrix[i][j] == INTERSECTING_LINE)
-                cost[i][j] += min;
-        }
-    }
+    char *used = calloc(nSeed + 1, sizeof(char));
+    assert(used != NULL);
+    int k, p, all = TRUE;
+    for (k = 0; k < lists->nLists; k++)
+        for (p = 0; p < lists->len[k]; p++)
+            if (lists->ids[k][p] < nSeed) used[lists->ids[k][p]] = TRUE;
+    for (k = 0; k < nSeed; k++) if (!used[k]) all = FALSE;
+    free(used);
+    return all;
 }
 
 
-// finds the minimum index that is uncovered in the matrix
-double findUncoveredAreaMin(double **matrix, int **coverMatrix, int size)
+// exits if name is not one of the choices
+int choice(int value, char *what, char *name)
 {
-    int row, col;
-    double min = INT_MAX;
-    for (col = 0; col < size; col++) {
-        for (row = 0; row < size; row++) {
-            if (!coverMatrix[row][col]) min = MIN(min, matrix[row][col]);
-        }
+    if (value == UNKNOWN_NAME) {
+        fprintf(stderr, "Unknown %s %s\n", what, name);
+        exit(EXIT_FAILURE);
     }
-    return min;
+    return value;
 }
 
 
-// helper function for the Merge Sort
-void rankMerge(rankFP *array, int start, int middle, int end)
+// exits unless text is a number greater than zero
+double positive(char *text, char *what)
 {
-    int leftLength = middle - start + SHIFT;
-    int rightLength = end - middle;
-
-    // split given array in half
-    rankFP *left = malloc(sizeof(rankFP) * leftLength);
-    rankFP *right = malloc(sizeof(rankFP) * rightLength);
-    for (int i = 0; i < leftLength; i++) left[i] = array[start + i];
-    for (int i = 0; i < rightLength; i++) right[i] = array[middle + 1 + i];
-
-    // merging back in order
-    int i = 0, j = 0, k = start;
-    while (i < leftLength && j < rightLength) {
-        if (left[i]->finalPos <= right[j]->finalPos) {
-            array[k] = left[i];
-            i++;
-        } else {
-            array[k] = right[j];
-            j++;
-        }
-        k++;
+    char *end;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || !(value > 0)) {
+        fprintf(stderr, "%s must be a number greater than 0: %s\n", what, text);
+        exit(EXIT_FAILURE);
     }
-    // merging remaining elements
-    while (i < leftLength) {
-        array[k] = left[i];
-        i++; k++;
- 
-    }
-    while (j < rightLength) {
-        array[k] = right[j];
-        j++; k++;
-    }
-
-    free(left); free(right);
+    return value;
 }
 
 
-// Merge Sort that is used to order the URLS by  their Page Rank
-void rankMergeSort(rankFP *array, int start, int end)
+int main(int argc, char **argv) 
 {
-    if (start < end) {
-        // same as (start + end)/2, but avoids overflow for large 
-        // numbers
-        int middle = start + (end - start)/2;
-        // sort the two halves of the array
-        rankMergeSort(array, start, middle);
-        rankMergeSort(array, middle + SHIFT, end);
-        // merge these sorted halves
-        rankMerge(array, start, middle, end);
-
-    }
-}
-
-int posAlreadyTaken(rankFP *files, int pos, int numURLs) {
+    statsInit(&argc, argv);
     int i;
-    for (i = 0; i < numURLs; i++) {
-        if (files[i]->finalPos == pos) return TRUE;
-    }
-    return FALSE;
-}
-
-
-/* TO DO */
-void getPosition(double **cost, rankFP *files, int numURLs, double *sum, double **ogCost)
-{
-    int i, j;
-    for (i = 0; i < numURLs; i++) {
-        for (j = 0; j < numURLs; j++) {
-            if (cost[i][j] != 0.0) continue;
-            if (posAlreadyTaken(files, j+1, numURLs)) continue;
-            files[i]->finalPos = j+1;
-            *sum = *sum + ogCost[i][j];
-            break;
+    char *modeName = EXACT, *solverName = "hungarian";
+    char *report = NULL, *warmFile = NULL;
+    AggOptions opts;
+    defaultAggOptions(&opts);
+    char **fileNames = malloc(argc * sizeof(char *));
+    assert(fileNames != NULL);
+    int nFiles = 0;
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], MODE_FLAG, strlen(MODE_FLAG)) == 0) {
+            modeName = argv[i] + strlen(MODE_FLAG);
+            opts.mode = choice(aggModeByName(modeName), "mode", modeName);
+        } else if (strncmp(argv[i], WINDOW_FLAG, strlen(WINDOW_FLAG)) == 0) {
+            opts.window = atoi(argv[i] + strlen(WINDOW_FLAG));
+        } else if (strncmp(argv[i], SOLVER_FLAG, strlen(SOLVER_FLAG)) == 0) {
+            solverName = argv[i] + strlen(SOLVER_FLAG);
+            opts.solver = choice(aggSolverByName(solverName), "solver", solverName);
+        } else if (strncmp(argv[i], TOP_FLAG, strlen(TOP_FLAG)) == 0) {
+            opts.top = atoi(argv[i] + strlen(TOP_FLAG));
+        } else if (strncmp(argv[i], BAND_FLAG, strlen(BAND_FLAG)) == 0) {
+            opts.band = atoi(argv[i] + strlen(BAND_FLAG));
+        } else if (strncmp(argv[i], EPS_FLAG, strlen(EPS_FLAG)) == 0) {
+            opts.eps = positive(argv[i] + strlen(EPS_FLAG), "eps");
+        } else if (strncmp(argv[i], THREADS_FLAG, strlen(THREADS_FLAG)) == 0) {
+            opts.nThreads = atoi(argv[i] + strlen(THREADS_FLAG));
+        } else if (strncmp(argv[i], WARM_FLAG, strlen(WARM_FLAG)) == 0) {
+            warmFile = argv[i] + strlen(WARM_FLAG);
+            opts.warm = TRUE;
+        } else if (strncmp(argv[i], REPORT_FLAG, strlen(REPORT_FLAG)) == 0) {
+            report = argv[i][strlen(REPORT_FLAG)] == '=' ?
+                     argv[i] + strlen(REPORT_FLAG) + 1 : "";
+        } else {
+            fileNames[nFiles++] = argv[i];
         }
     }
-}
-
-
-double getURLOrder(double **cost, rankFP *files, int length, double **ogCost)
-{
-    /* Need to figure out how to get each URL's position from the matrix */
-    double sum = 0;
-    getPosition(cost, files, length + 1, &sum, ogCost);
-    rankMergeSort(files, 0, length);
-    return sum;
-}
-
-/* Frees a double 2d array */
-void freeDoubleMatrix(double **matrix, int size) 
-{
-    int i;
-    for (i = 0; i < size; i++) 
-        free(matrix[i]);
-    free(matrix);
-}
-
-/* Frees an int 2d array */
-void freeIntMatrix(int **matrix, int size) 
-{
-    int i;
-    for (i = 0; i < size; i++) 
-        free(matrix[i]);
-    free(matrix);
-}
-
-/* Free rankFP pointer */
-void freeFiles(rankFP *files, int size)
-{
-    int i;
-    for (i = 0; i < size; i++) {
-        free(files[i]->fileName);
-        free(files[i]);
+    // the top K solve would silently replace the solver asked for
+    if (opts.top > 0 && (opts.solver != SOLVER_HUNGARIAN || opts.warm)) {
+        fprintf(stderr, "--top cannot be used with --solver=auction, --solver=banded or --warm\n");
+        exit(EXIT_FAILURE);
     }
-    free(files);
-}
-
-// get set of URLS
-// for each rank file, read into info into URL array
-// set the matrix values based on the info in the URL array
-
-int main(int argc, char **argv) 
-{
-    int i;
      // Number of files given.
-    if (argc - 1 == 0) {
-        printf("Usage: ./scaledFootrule fileName ...\n");
+    if (nFiles == 0) {
+        printf("Usage: ./scaledFootrule [--mode=exact|median|borda|markov] "
+               "[--window=W] [--solver=hungarian|auction|banded] [--eps=E] "
+               "[--threads=T] [--band=W] [--top=K] [--warm=FILE] "
+               "[--report[=exact]] fileName ...\n");
         exit(1);
     }
-    Set unionURL = GetAllUrls(argc, argv);
-    double numURLs = nElems(unionURL) + 0.0;
-    /* building ADT that represents the URLs and their positions within the 
-    rank files */
-    rankFP *files = calloc(numURLs, sizeof(rankFP));
-    buildRankADT(files, argv, argc);
-    /* 1. Represent a cost matrix with an n x n 2d array.
-          cost[url][pos] */
-    double **cost = malloc(numURLs * sizeof(double));
-    for (i = 0; i < numURLs; i++)
-        cost[i] = malloc(numURLs * sizeof(double));
-    double **ogCost = malloc(numURLs * sizeof(double));
-    for (i = 0; i < numURLs; i++) 
-        ogCost[i] = malloc(numURLs * sizeof(double));
-    
-    /* 2. Calculate the footrule distance for each [row][col] */
-    int row, col;
-    i = 0;
-    for (row = 0; row < numURLs; row++) {
-        for (col = 0; col < numURLs; col++) {
-            cost[row][col] = calcSFRDist(files[i]->posData, col+1, numURLs);
-            ogCost[row][col] = calcSFRDist(files[i]->posData, col+1, numURLs);
+    RankAgg agg = newRankAgg();
+    struct rankLists lists;
+    // URLs keep the numbers of the saved state, unless the union changed
+    int nSeed = 0;
+    double start = statsClock();
+    char **seed = warmFile != NULL ? readWarm(warmFile, agg, &nSeed) : NULL;
+    readRankFiles(fileNames, nFiles, seed, nSeed, &lists);
+    if (seed != NULL && (lists.nURLs != nSeed || !seedsUsed(&lists, nSeed))) {
+        freeLists(&lists);
+        readRankFiles(fileNames, nFiles, NULL, 0, &lists);
+    }
+    for (i = 0; i < nSeed; i++) free(seed[i]);
+    free(seed);
+    statsTime("read", start);
+    int numURLs = lists.nURLs;
+    int nOrder = aggOrderLength(numURLs, &opts);
+    int *order = malloc((numURLs + 1) * sizeof(int));
+    assert(order != NULL);
+
+    start = statsClock();
+    double sum = aggregateRanks(agg, lists.ids, lists.len, lists.nLists,
+                                numURLs, &opts, order);
+    double seconds = statsClock() - start;
+    statsAddTime("aggregate", seconds);
+
+    if (report != NULL) {
+        fprintf(stderr, "mode %s%s%s: distance %f, %.6f s\n", modeName,
+                opts.mode == AGG_EXACT ? " " : "",
+                opts.mode == AGG_EXACT ? solverName : "", sum, seconds);
+        if (strcmp(report, EXACT) == 0) {
+            int *best = malloc((numURLs + 1) * sizeof(int));
+            assert(best != NULL);
+            AggOptions optimal;
+            defaultAggOptions(&optimal);
+            optimal.top = opts.top;
+            // a separate aggregator so the warm start state is untouched
+            RankAgg check = newRankAgg();
+            start = statsClock();
+            double optimum = aggregateRanks(check, lists.ids, lists.len, lists.nLists,
+                                            numURLs, &optimal, best);
+            disposeRankAgg(check);
+            seconds = statsClock() - start;
+            double gap = sum - optimum;
+            fprintf(stderr, "exact: distance %f, %.6f s, gap %f (%.2f%%)\n",
+                    optimum, seconds, gap, optimum > 0 ? 100 * gap / optimum : 0.0);
+            free(best);
         }
-        i++;
     }
-    /* 3. Subtract row minima */
-    rowReduce(cost, numURLs);
-    /* 4. Subtract col minima */
-    colReduce(cost, numURLs);
-    // Keeps track of the number of zeros in each row and col respectively.
-    int **zeroCount = countZeroes(cost, numURLs);
 
-    // 2d array that reflects cost matrix.
-    // 0 means not covered, and > 0 means covered.
-    int **coverMatrix = calloc(numURLs, sizeof(int *));
-    for (i = 0; i < numURLs; i++) 
-        coverMatrix[i] = calloc(numURLs, sizeof(int));
-    /* 5. Count number of lines L required to cover all the 0s */
-    while (numLinesToCoverZeroes(coverMatrix, zeroCount, cost, numURLs) != numURLs) {
-        /* 6. Find smallest number from uncovered area */
-        double min = findUncoveredAreaMin(cost, coverMatrix, numURLs);
-        /* Subtract this number from all UNCOVERED ROWS */
-        rowReduceUncovered(coverMatrix, min, cost, numURLs);
-        /* Add new smallest number to COVERED COLS */
-        // is this function right, shouldnt it be == 1 or 2??
-        colAddCovered(coverMatrix, min, cost, numURLs);
-        /* Go back to step 5 and repeat */
-    }
-    double sum = getURLOrder(cost, files, numURLs - 1, ogCost); // sort normally
+    start = statsClock();
     printf("%f\n", sum);
-    for (i = 0; i < numURLs; i++) {
-        printf("%s\n", files[i]->fileName);
+    for (i = 0; i < nOrder; i++) {
+        printf("%s\n", lists.names[order[i]]);
     }
+    statsTime("output", start);
+
+    if (warmFile != NULL) writeWarm(warmFile, agg, &lists);
 
     // Cleaning up.
-    disposeSet(unionURL);
-    freeDoubleMatrix(cost, numURLs);
-    freeDoubleMatrix(ogCost, numURLs);
-    freeIntMatrix(zeroCount, 2);
-    freeIntMatrix(coverMatrix, numURLs);
-    freeFiles(files, numURLs);
+    disposeRankAgg(agg);
+    free(order);
+    free(fileNames);
+    freeLists(&lists);
 
     return 0;
 }
-
-
@@ -26,12 +26,19 @@ Output order urls on stdout
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <assert.h>
 #include "set.h"
 #include "graph.h"
 #include "BSTree.h"
 #include "readData.h"
 #include "mystring.h"
+#include "analyser.h"
+#include "termDict.h"
+#include "rankTable.h"
+#include "stats.h"
 
+#define INDEX_FILE  "invertedIndex.txt"
+#define PAGERANK_FILE "pagerankList.txt"
 #define MAX_LINE    1001
 #define URL_LENGTH  55
 #define SHIFT       1
@@ -60,20 +67,34 @@ void dumpSearchPR(urlPR *array, int nElems)
 }
 
 
-/* Gets the URLs that contain word. */
-char **getURLs(char *word) 
+/* Gets the URLs that contain word, looked up in dict if there is one
+ * and it still matches the index, and by scanning the index otherwise. */
+char **getURLs(char *word, TermDict dict) 
 {
-    FILE *invIndex = fopen("invertedIndex.txt", "r");
+    FILE *invIndex = statsFopen(INDEX_FILE, "r");
     if (!invIndex) { perror("fopen failed"); exit(EXIT_FAILURE); }
 
     char line[MAX_LINE] = {0};
     char lineWord[MAX_LINE] = {0};
     char *urlString = NULL;
     char **urls = NULL;
-    while (fgets(line, MAX_LINE, invIndex) != NULL) {
+    // the dictionary gives the only line the word can be on
+    int found = dict != NULL ? termDictLine(dict, invIndex, word, line, MAX_LINE) : TERM_STALE;
+    if (found != TERM_STALE) {
+        if (found) {
+            urlString = line + strlen(word);
+            trim(urlString);
+            urls = tokenise(urlString, " ");
+        }
+        fclose(invIndex);
+        return urls;
+    }
+    // no dictionary, or one that no longer matches the index
+    rewind(invIndex);
+    while (statsFgets(line, MAX_LINE, invIndex) != NULL) {
         sscanf(line, "%s", lineWord);
         // Finds the wanted word.
-        if (strcmp(lineWord, word) == 0) {
+        if (STATS_STRCMP(lineWord, word) == 0) {
             urlString = line + strlen(word); // Moves pointer to urls part.
             trim(urlString);
             // Get an array of url names.
@@ -101,18 +122,18 @@ void countOccurences(char **URLs, urlPR *searchPR, int elems)
 	int i, j;
 	for (i = 0; i < elems; i++) {
 		for (j = 0; URLs[j] != NULL; j++) {
-			if (strcmp(searchPR[i]->URL, URLs[j]) == 0) searchPR[i]->searchTerms++;
+			if (STATS_STRCMP(searchPR[i]->URL, URLs[j]) == 0) searchPR[i]->searchTerms++;
 		}
 	}
 }
 
 int numOfElems()
 {
-    FILE *pagerankList = fopen("pagerankList.txt", "r");
+    FILE *pagerankList = statsFopen("pagerankList.txt", "r");
     if (!pagerankList) { perror("fopen failed"); exit(EXIT_FAILURE); }
 	int i = 0;
     char line[MAX_LINE] = {0};
-    while (fgets(line, MAX_LINE, pagerankList) != NULL) i++;
+    while (statsFgets(line, MAX_LINE, pagerankList) != NULL) i++;
 	fclose(pagerankList);
 	return i;
 }
@@ -120,13 +141,13 @@ int numOfElems()
 urlPR *getPageRanks(int *elems) 
 {
 	*elems = numOfElems();
-    FILE *pagerankList = fopen("pagerankList.txt", "r");
+    FILE *pagerankList = statsFopen("pagerankList.txt", "r");
     if (!pagerankList) { perror("fopen failed"); exit(EXIT_FAILURE); }
     char line[MAX_LINE] = {0};
 	int links;
 	urlPR *searchPR = malloc(sizeof(struct url) * *elems);
 	int i = 0;
-    while (fgets(line, MAX_LINE, pagerankList) != NULL) {
+    while (statsFgets(line, MAX_LINE, pagerankList) != NULL) {
 		searchPR[i] = newSearchPRNode();
         sscanf(line, "%s %d, %f", searchPR[i]->URL, &links, &searchPR[i]->pageRank);
         // make sure the URL string is null terminated
@@ -197,23 +218,89 @@ void PRmergeSort(int searchBy, urlPR *array, int start, int end)
     }
 }
 
+/* countOccurences for the mapped rank table: counts[pos] is the number
+ * of query words the URL at position pos has, and the positions with a
+ * count are listed in matched (*nMatched of them).
+ */
+void countInTable(char **URLs, RankTable table, int *counts, int *matched, int *nMatched)
+{
+	int j;
+	for (j = 0; URLs[j] != NULL; j++) {
+		int pos = rankTableFind(table, URLs[j]);
+		if (pos < 0) continue;
+		if (counts[pos]++ == 0) matched[(*nMatched)++] = pos;
+	}
+}
+
+
+static int *tableCounts;
+
+// most search terms first, then list order, which is by pagerank
+static int cmpMatched(const void *a, const void *b)
+{
+	int x = *(int *)a, y = *(int *)b;
+	if (tableCounts[x] != tableCounts[y]) return tableCounts[y] - tableCounts[x];
+	return x - y;
+}
+
+
 // Does it matter if the same word occurs twice in a url?
 int main(int argc, char **argv)
 {
+	statsInit(&argc, argv);
 	int i;
 	int elems;
-    // read pageranks and inverted list into search pagerank ADT
-	urlPR *searchPR = getPageRanks(&elems);
+    // read pageranks and inverted list into search pagerank ADT, or map
+    // their binary copy if it is up to date
+	double start = statsClock();
+	urlPR *searchPR = NULL;
+	int *matched = NULL, nMatched = 0;
+	RankTable table = loadRankTable(RANK_TABLE, PAGERANK_FILE);
+	if (table != NULL) {
+		elems = rankTableSize(table);
+		tableCounts = calloc(elems + 1, sizeof(int));
+		matched = malloc((elems + 1) * sizeof(int));
+		assert(tableCounts != NULL && matched != NULL);
+	} else {
+		searchPR = getPageRanks(&elems);
+	}
+	statsTime("pageranks", start);
+	start = statsClock();
+	// query words go through the same analysis as the indexed pages
+	Analyser analyser = loadAnalyser();
+	TermDict dict = loadTermDict(INDEX_FILE, DICT_FILE);
 	for (i = 1; i < argc; i++) {
-		char **URLs = getURLs(argv[i]);
+		char *word = argv[i];
+		if (analyser != NULL) {
+			word = normalise(argv[i]);
+			if (analyseWord(analyser, word, strlen(word)) == 0) { free(word); continue; }
+		}
+		char **URLs = getURLs(word, dict);
+		if (word != argv[i]) free(word);
 		if (URLs == NULL) continue;
-		countOccurences(URLs, searchPR, elems);
+		if (table != NULL) countInTable(URLs, table, tableCounts, matched, &nMatched);
+		else countOccurences(URLs, searchPR, elems);
 		freeTokens(URLs);
 	}
+	freeAnalyser(analyser);
+	freeTermDict(dict);
+	statsTime("lookup", start);
+	if (table != NULL) {
+		start = statsClock();
+		qsort(matched, nMatched, sizeof(int), cmpMatched);
+		statsTime("sort", start);
+		for (i = 0; i < nMatched && i < MAX_PRINT; i++)
+			printf("%s\n", rankTableURL(table, matched[i]));
+		free(tableCounts); free(matched);
+		freeRankTable(table);
+		return 0;
+	}
     // sort the ADT by pagerank
+	start = statsClock();
 	PRmergeSort(PAGERANK, searchPR, 0, elems-SHIFT);
     // sort the ADT again by number of search terms each URL contains
 	PRmergeSort(SEARCHTERMS, searchPR, 0, elems-SHIFT);
+	statsTime("sort", start);
     // print ordered URLs
 	for (i = 0; i < elems && i < MAX_PRINT; i++) {
 		if (searchPR[i]->searchTerms == 0) continue;
@@ -25,7 +25,12 @@
 #include "BSTree.h"
 #include "readData.h"
 #include "mystring.h"
+#include "tokeniser.h"
+#include "analyser.h"
+#include "termDict.h"
+#include "stats.h"
 
+#define INDEX_FILE  "invertedIndex.txt"
 #define MAX_LINE 1001
 #define URL_LENGTH      55
 #define SHIFT 1
@@ -39,8 +44,8 @@ struct TFIDFNode {
     double tfIdf;
 };
 
-char **getURLs(char *word);
-double calcTf(char *URLName, char *word);
+char **getURLs(char *word, TermDict dict);
+double calcTf(char *URLName, char *word, Analyser analyser, TokenBuffer words);
 double calcIdf(int nURLs, int totalURLs);
 void TFMerge(TFNode *array, int start, int middle, int end);
 void TFmergeSort(TFNode *array, int start, int end);
@@ -60,27 +65,44 @@ int main(int argc, char **argv)
     int i;
     // int index;
 
+    statsInit(&argc, argv);
     int nSearchwords = argc - 1;
+    double start = statsClock();
     Set URLList = getCollection();
+    statsTime("load", start);
     int totalURLs = nElems(URLList);
 
-    // Inserts all search words into a set.
+    // Inserts all search words into a set, analysed the same way as the
+    // indexed pages.
+    Analyser analyser = loadAnalyser();
+    TermDict dict = loadTermDict(INDEX_FILE, DICT_FILE);
     Set searchWords = newSet();
-    for (i = 0; i < nSearchwords; i++)
-        insertInto(searchWords, argv[i+1]);
+    for (i = 0; i < nSearchwords; i++) {
+        if (analyser == NULL) {
+            insertInto(searchWords, argv[i+1]);
+            continue;
+        }
+        char *word = normalise(argv[i+1]);
+        if (analyseWord(analyser, word, strlen(word)) != 0)
+            insertInto(searchWords, word);
+        free(word);
+    }
 
     // Array of size nURLs to keep track of tf-idf of each URL.
     URLTfIdf = malloc(totalURLs * sizeof(TFNode));
     
-    // For each URL, calcualte tf-idf.
+    // For each URL, calcualte tf-idf, splitting every page into the same
+    // buffer.
+    start = statsClock();
+    TokenBuffer pageWords = newTokenBuffer();
     SetNode word, currURL = URLList->elems;
     for (i = 0; i < totalURLs; i++) {
         tfIdf = 0;
         // For each search word wanted, sum up tf-idf for each search word.
         for (word = searchWords->elems; word != NULL; word = word->next) {
-            URLs = getURLs(word->val);
+            URLs = getURLs(word->val, dict);
             if (!URLs) continue;
-            tf = calcTf(currURL->val, word->val);
+            tf = calcTf(currURL->val, word->val, analyser, pageWords);
             idf = calcIdf(numURLs(URLs), totalURLs);
             tfIdf += tf * idf;
             freeTokens(URLs);
@@ -91,14 +113,20 @@ int main(int argc, char **argv)
 
         currURL = currURL->next;
     }
+    freeTokenBuffer(pageWords);
+    statsTime("tfIdf", start);
     // sort URLS by Tfidf
+    start = statsClock();
     TFmergeSort(URLTfIdf, 0, totalURLs-1);
+    statsTime("sort", start);
     printTfIdf(URLTfIdf, totalURLs-1);
 
     // free memory
     disposeSet(searchWords);
     disposeSet(URLList);
     disposeTfIdf(URLTfIdf, totalURLs);
+    freeAnalyser(analyser);
+    freeTermDict(dict);
 
     return 0;
 }
@@ -134,20 +162,34 @@ int numURLs(char **URLs)
     return URLcount;
 }
 
-/* Gets the URLs that contain word. */
-char **getURLs(char *word) 
+/* Gets the URLs that contain word, looked up in dict if there is one
+ * and it still matches the index, and by scanning the index otherwise. */
+char **getURLs(char *word, TermDict dict) 
 {
-    FILE *invIndex = fopen("invertedIndex.txt", "r");
+    FILE *invIndex = statsFopen(INDEX_FILE, "r");
     if (!invIndex) { perror("fopen failed"); exit(EXIT_FAILURE); }
 
     char line[MAX_LINE] = {0};
     char lineWord[MAX_LINE] = {0};
     char *urlString = NULL;
     char **urls = NULL;
-    while (fgets(line, MAX_LINE, invIndex) != NULL) {
+    // the dictionary gives the only line the word can be on
+    int found = dict != NULL ? termDictLine(dict, invIndex, word, line, MAX_LINE) : TERM_STALE;
+    if (found != TERM_STALE) {
+        if (found) {
+            urlString = line + strlen(word);
+            trim(urlString);
+            urls = tokenise(urlString, " ");
+        }
+        fclose(invIndex);
+        return urls;
+    }
+    // no dictionary, or one that no longer matches the index
+    rewind(invIndex);
+    while (statsFgets(line, MAX_LINE, invIndex) != NULL) {
         sscanf(line, "%s", lineWord);
         // Finds the wanted word.
-        if (strcmp(lineWord, word) == 0) {
+        if (STATS_STRCMP(lineWord, word) == 0) {
             urlString = line + strlen(word); // Moves pointer to urls part.
             trim(urlString);
             // Get an array of url names.
@@ -160,8 +202,12 @@ char **getURLs(char *word)
 }
 
 
-/* Calculates how frequently a term appears in a url. */
-double calcTf(char *URLName, char *word) 
+/* Calculates how frequently a term appears in a url. word has already
+ * been analysed; the page is split into words, reusing the caller's
+ * buffer, and analysed here. Stop words still count towards the total so
+ * tf keeps its meaning.
+ */
+double calcTf(char *URLName, char *word, Analyser analyser, TokenBuffer words) 
 {
     // Opening URL.txt file.
     char fileName[URL_LENGTH] = {0};
@@ -174,20 +220,18 @@ double calcTf(char *URLName, char *word)
     char *text = calloc(text_size, sizeof(char));
     readPage(urls, text, fileName);
 
-    char *dump = text; // For freeing.
-    char *found;
     double wordCount = 0, searchCount = 0;
     char *wanted = normalise(word);
+    int wantedLen = strlen(wanted);
     // Counts total words & num of wanted word in file.
-    while ((found = strsep(&text, " ")) != NULL) {
-        if (strcmp(found, "") != 0) {
-            char *str = normalise(found);
-            if (strcmp(str, wanted) == 0) searchCount++;
-            wordCount++;
-            free(str);
-        }
+    int i, nWords = tokeniseText(words, text);
+    for (i = 0; i < nWords; i++) {
+        char *token = words->text + words->start[i];
+        int len = analyseWord(analyser, token, words->len[i]);
+        if (len == wantedLen && memcmp(token, wanted, wantedLen) == 0) searchCount++;
     }
-    free(wanted); free(dump); free(urls);
+    wordCount = nWords;
+    free(wanted); free(text); free(urls);
 
     return searchCount/wordCount;
 }
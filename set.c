@@ -7,9 +7,10 @@
 #include <string.h>
 #include "set.h"
 #include "mystring.h"
+#include "stats.h"
 
-#define strEQ(s,t) (strcmp((s),(t)) == 0)
-#define strLT(s,t) (strcmp((s),(t)) < 0)
+#define strEQ(s,t) (STATS_STRCMP((s),(t)) == 0)
+#define strLT(s,t) (STATS_STRCMP((s),(t)) < 0)
 
 // Function signatures
 
@@ -128,6 +129,7 @@ void showSet(Set s)
 static SetNode newNode(char *str)
 {
 	SetNode new = malloc(sizeof(Node));
+	STATS_ADD(STAT_ALLOCS, 1);
 	assert(new != NULL);
 	new->val = mystrdup(str);
 	new->next = NULL;
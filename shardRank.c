@@ -0,0 +1,227 @@
+/* shardRank.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * LAYOUT OF THE SHARED REGION:
+ *  ShardShared header (one turn semaphore per shard, stop flag, count)
+ *  double ranks[nURLs]         rank vector, updated in place
+ *  double traceResidual[k]     per-iteration residual (k capped)
+ *  double traceSeconds[k]      per-iteration time, shard 0 to the last
+ *
+ * LOADING:
+ * The calling process only scans the edge file (sorted by destination)
+ * to cut it into slices; it keeps no graph. Each worker then reads the
+ * records of its own slice from the file, so no process ever holds more
+ * than its share of the in-links plus the two shared rank vectors.
+ *
+ * EACH ITERATION:
+ * The update is the in-place sweep of PageRankW (see sweepEdges in
+ * edgeFile.c, which the stream uses too), so the output is the same as
+ * the default mode's. A URL needs the new ranks of every lower ID, so
+ * the shards take turns in ID order:
+ * 1. Shard s waits for its turn, sweeps its slice in place, reading the
+ *    new ranks of the lower shards and the previous ones of the higher.
+ * 2. It adds its residual to the iteration's and passes the turn on.
+ * 3. The last shard owns the last URL, whose change decides whether to
+ *    stop; it sets the stop flag and hands the turn back to shard 0,
+ *    and every shard passes the flag along as it leaves.
+ * The shards split the memory of the in-links, not the time of an
+ * iteration. The ranks a shard reads from outside its slice are its
+ * boundary. Here they come straight from the shared vector; spreading
+ * the shards over machines only means shipping those boundary values
+ * with the turn instead.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <time.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "edgeFile.h"
+#include "prTrace.h"
+#include "shardRank.h"
+
+#define MAX_TRACE_ITERS 100000
+#define READ_BATCH      4096
+
+typedef struct shardShared {
+    sem_t turn[MAX_SHARDS];
+    int   stop;
+    int   nIters;
+} ShardShared;
+
+typedef struct shard {
+    int         lo, hi;     // owned URL IDs lo .. hi-1
+    long        nRecords;   // local copy of the owned in-links
+    EdgeRecord *records;
+} Shard;
+
+
+/* Splits the IDs so each shard gets about the same URLs + in-links:
+ * shard s owns bound[s] .. bound[s+1]-1, whose in-links are records
+ * first[s] .. first[s+1]-1 of the edge file. One scan of the file, which
+ * is positioned at its first record.
+ */
+static void partition(FILE *file, EdgeFileHeader *header, int nShards, int *bound, long *first)
+{
+    int n = header->nURLs, s = 1, v = 0;
+    long total = header->nEdges + n, r = 0;
+    EdgeRecord *batch = malloc(READ_BATCH * sizeof(EdgeRecord));
+    assert(batch != NULL);
+    size_t got, k;
+    // v's in-links start at the first record with dst >= v; bound[s] is
+    // the first v with that position + v reaching s/nShards of the total
+    while ((got = fread(batch, sizeof(EdgeRecord), READ_BATCH, file)) > 0) {
+        for (k = 0; k < got; k++, r++) {
+            for (; v <= batch[k].dst && v < n; v++) {
+                for (; s < nShards && r + v >= total * s / nShards; s++) {
+                    bound[s] = v;
+                    first[s] = r;
+                }
+            }
+        }
+    }
+    for (; v < n; v++) {
+        for (; s < nShards && r + v >= total * s / nShards; s++) {
+            bound[s] = v;
+            first[s] = r;
+        }
+    }
+    for (; s < nShards; s++) {
+        bound[s] = n;
+        first[s] = header->nEdges;
+    }
+    bound[0] = 0; first[0] = 0;
+    bound[nShards] = n; first[nShards] = header->nEdges;
+    free(batch);
+}
+
+
+// reads the in-links of URLs lo .. hi-1, records first .. last-1
+static void loadShard(char *fileName, Shard *s, int lo, int hi, long first, long last)
+{
+    s->lo = lo; s->hi = hi;
+    s->nRecords = last - first;
+    s->records = malloc((s->nRecords + 1) * sizeof(EdgeRecord));
+    assert(s->records != NULL);
+    EdgeFileHeader header;
+    FILE *file = openEdgeFile(fileName, &header);
+    fseek(file, first * sizeof(EdgeRecord), SEEK_CUR);
+    if (fread(s->records, sizeof(EdgeRecord), s->nRecords, file) != (size_t)s->nRecords) {
+        fprintf(stderr, "%s: short read\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    fclose(file);
+}
+
+
+/* Body of one worker process. */
+static void runShard(Shard *s, int id, int nShards, int nURLs, ShardShared *shared,
+                     double *ranks, double *traceResidual, double *traceSeconds,
+                     int traced, double damp, double diffPR, int maxIterations)
+{
+    int iter;
+    for (iter = 0; ; iter++) {
+        sem_wait(&shared->turn[id]);
+        if (shared->stop) {
+            if (id + 1 < nShards) sem_post(&shared->turn[id + 1]);
+            break;
+        }
+        if (id == 0 && iter < traced) traceSeconds[iter] = traceClock();
+        EdgeSweep sweep;
+        startSweep(&sweep, s->lo, nURLs, damp);
+        sweepEdges(&sweep, s->records, s->nRecords, ranks);
+        finishSweep(&sweep, s->hi, ranks);
+        if (iter < traced) traceResidual[iter] += sweep.residual;
+        if (id == nShards - 1) {
+            if (iter < traced) traceSeconds[iter] = traceClock() - traceSeconds[iter];
+            shared->nIters = iter + 1;
+            shared->stop = iter + 1 >= maxIterations || sweep.lastDiff < diffPR;
+        }
+        sem_post(&shared->turn[(id + 1) % nShards]);
+    }
+}
+
+
+int shardPageRank(char *fileName, double damp, double diffPR, int maxIterations,
+                  int nShards, double *ranks, PRTrace trace)
+{
+    EdgeFileHeader header;
+    FILE *file = openEdgeFile(fileName, &header);
+    int n = header.nURLs;
+    if (nShards < 1) nShards = 1;
+    if (nShards > MAX_SHARDS) nShards = MAX_SHARDS;
+    if (nShards > n) nShards = n > 0 ? n : 1;
+    int traced = maxIterations < MAX_TRACE_ITERS ? maxIterations : MAX_TRACE_ITERS;
+    if (traced < 0) traced = 0;
+
+    size_t size = sizeof(ShardShared) + ((size_t)n + 2 * traced) * sizeof(double);
+    void *region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) { perror("mmap failed"); exit(EXIT_FAILURE); }
+    ShardShared *shared = region;
+    double *current = (double *)(shared + 1);
+    double *traceResidual = current + n;
+    double *traceSeconds = traceResidual + traced;
+    memset(shared, 0, sizeof(ShardShared));
+    int v, s;
+    for (v = 0; v < n; v++) current[v] = 1.0/n;
+    for (v = 0; v < traced; v++) traceResidual[v] = 0;
+    for (s = 0; s < nShards; s++) {
+        if (sem_init(&shared->turn[s], 1, 0) != 0) { perror("sem_init failed"); exit(EXIT_FAILURE); }
+    }
+    // like PageRankW, no sweep at all without iterations
+    shared->stop = maxIterations <= 0;
+
+    int bound[MAX_SHARDS + 1];
+    long first[MAX_SHARDS + 1];
+    partition(file, &header, nShards, bound, first);
+    fclose(file);
+    pid_t workers[MAX_SHARDS];
+    fflush(NULL);
+    for (s = 0; s < nShards; s++) {
+        workers[s] = fork();
+        if (workers[s] < 0) { perror("fork failed"); exit(EXIT_FAILURE); }
+        if (workers[s] == 0) {
+            Shard shard;
+            loadShard(fileName, &shard, bound[s], bound[s + 1], first[s], first[s + 1]);
+            runShard(&shard, s, nShards, n, shared, current, traceResidual, traceSeconds,
+                     traced, damp, diffPR, maxIterations);
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    sem_post(&shared->turn[0]);
+    // workers are reaped as they exit: one that dies leaves the others
+    // waiting for their turn forever, so they are killed
+    int failed = 0, running = nShards, status;
+    while (running > 0) {
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) { failed = 1; break; }
+        for (s = 0; s < nShards && workers[s] != pid; s++);
+        if (s == nShards) continue;
+        workers[s] = 0;
+        running--;
+        if (!failed && (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)) {
+            failed = 1;
+            for (s = 0; s < nShards; s++) if (workers[s] > 0) kill(workers[s], SIGKILL);
+        }
+    }
+    if (failed) { fprintf(stderr, "pagerank shard failed\n"); exit(EXIT_FAILURE); }
+
+    int iters = shared->nIters;
+    memcpy(ranks, current, n * sizeof(double));
+    for (v = 0; v < iters && v < traced; v++)
+        traceRecord(trace, traceResidual[v], header.nEdges, traceSeconds[v]);
+    for (s = 0; s < nShards; s++) sem_destroy(&shared->turn[s]);
+    munmap(region, size);
+    return iters;
+}
@@ -0,0 +1,28 @@
+/* shardRank.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * PageRank split across worker processes. Each worker owns a contiguous
+ * slice of URL IDs and reads only their in-links from the edge file (see
+ * edgeFile.h). The workers share one rank vector in shared memory and
+ * take turns in ID order to sweep their slices, so the result is the
+ * same as the default mode's.
+ */
+
+#include "prTrace.h"
+
+#ifndef SHARDRANK_H
+#define SHARDRANK_H
+
+#define MAX_SHARDS  64
+
+/* Weighted PageRank over the edge file fileName using nShards forked
+ * workers, with the updates and stop rule of streamPageRank; the caller
+ * holds only the rank vector. Final ranks go in ranks, by ID; returns
+ * the number of iterations.
+ */
+int shardPageRank(char *fileName, double damp, double diffPR, int maxIterations,
+                  int nShards, double *ranks, PRTrace trace);
+
+#endif
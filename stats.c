@@ -0,0 +1,124 @@
+/* stats.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * The summary looks like
+ *  {"program": "pagerank", "seconds": 1.52, "maxRssKB": 5120,
+ *   "timers": {"load": {"seconds": 0.01, "calls": 1}, ...},
+ *   "counters": {"filesOpened": 2001, "bytesRead": 812345, ...}}
+ * Timers are kept in the order they were first used. A program has only
+ * a handful, so they are found by name with a linear scan.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "stats.h"
+
+#define TRUE        1
+#define FALSE       0
+#define MAX_TIMERS  32
+
+typedef struct timer {
+    char  *name;
+    double seconds;
+    long   calls;
+} Timer;
+
+int  statsOn = FALSE;
+long statsCounter[N_STATS];
+
+static char  *counterNames[N_STATS] = {
+    "filesOpened", "bytesRead", "tokens", "allocations", "strcmpCalls"
+};
+static Timer  timers[MAX_TIMERS];
+static int    nTimers = 0;
+static char  *program = "";
+static double startTime;
+
+
+double statsClock()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+
+static void statsReport()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "{\"program\": \"%s\", \"seconds\": %.6f, \"maxRssKB\": %ld,\n",
+            program, statsClock() - startTime, usage.ru_maxrss);
+    fprintf(stderr, " \"timers\": {");
+    int i;
+    for (i = 0; i < nTimers; i++)
+        fprintf(stderr, "%s\"%s\": {\"seconds\": %.6f, \"calls\": %ld}",
+                i > 0 ? ", " : "", timers[i].name, timers[i].seconds, timers[i].calls);
+    fprintf(stderr, "},\n \"counters\": {");
+    for (i = 0; i < N_STATS; i++)
+        fprintf(stderr, "%s\"%s\": %ld", i > 0 ? ", " : "", counterNames[i], statsCounter[i]);
+    fprintf(stderr, "}}\n");
+}
+
+
+void statsInit(int *argc, char **argv)
+{
+    char *env = getenv(STATS_ENV);
+    int on = env != NULL && env[0] != '\0' && strcmp(env, "0") != 0;
+    int i, kept = 1;
+    for (i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], STATS_FLAG) == 0) on = TRUE;
+        else argv[kept++] = argv[i];
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    if (!on || statsOn) return;
+    char *slash = strrchr(argv[0], '/');
+    program = slash != NULL ? slash + 1 : argv[0];
+    startTime = statsClock();
+    statsOn = TRUE;
+    atexit(statsReport);
+}
+
+
+void statsAddTime(char *name, double seconds)
+{
+    if (!statsOn) return;
+    int i;
+    for (i = 0; i < nTimers && strcmp(timers[i].name, name) != 0; i++);
+    if (i == nTimers) {
+        if (nTimers == MAX_TIMERS) return;
+        timers[nTimers].name = name;
+        nTimers++;
+    }
+    timers[i].seconds += seconds;
+    timers[i].calls++;
+}
+
+
+void statsTime(char *name, double start)
+{
+    if (statsOn) statsAddTime(name, statsClock() - start);
+}
+
+
+FILE *statsFopen(char *fileName, char *mode)
+{
+    FILE *file = fopen(fileName, mode);
+    if (file != NULL) STATS_ADD(STAT_FILES, 1);
+    return file;
+}
+
+
+char *statsFgets(char *line, int size, FILE *file)
+{
+    char *got = fgets(line, size, file);
+    if (got != NULL) STATS_ADD(STAT_BYTES, strlen(line));
+    return got;
+}
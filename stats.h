@@ -0,0 +1,54 @@
+/* stats.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Lightweight run statistics shared by all the tools: named timers and
+ * a few counters of the work done (files opened, bytes read, tokens,
+ * allocations, strcmp calls). Collection is off unless the program is
+ * given --stats or STATS_ENV is set to anything but "0"; then a JSON
+ * summary is written to stderr when the program exits. While off every
+ * counter is a single untaken branch.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <string.h>
+
+#define STATS_FLAG  "--stats"
+#define STATS_ENV   "SEARCH_STATS"
+
+// counters
+#define STAT_FILES      0   // files opened
+#define STAT_BYTES      1   // bytes read from them
+#define STAT_TOKENS     2   // words split out of text
+#define STAT_ALLOCS     3   // strings and Set / BSTree / graph nodes allocated
+#define STAT_STRCMPS    4   // string comparisons in lookups
+#define N_STATS         5
+
+extern int  statsOn;
+extern long statsCounter[N_STATS];
+
+#define STATS_ADD(counter, n)   ((void)(statsOn ? (statsCounter[counter] += (n)) : 0))
+// strcmp(a, b), counted
+#define STATS_STRCMP(a, b)      (STATS_ADD(STAT_STRCMPS, 1), strcmp((a), (b)))
+
+/* Turns collection on if argv holds STATS_FLAG (which is removed, so the
+ * program's own parsing never sees it) or STATS_ENV is set, and arranges
+ * for the summary to be printed at exit.
+ */
+void statsInit(int *argc, char **argv);
+// seconds from an arbitrary fixed point, monotonic
+double statsClock();
+// adds the time since start (from statsClock) to timer name, which must
+// stay valid until exit (a string literal)
+void statsTime(char *name, double start);
+// adds seconds to timer name
+void statsAddTime(char *name, double seconds);
+// fopen and fgets that count files and bytes
+FILE *statsFopen(char *fileName, char *mode);
+char *statsFgets(char *line, int size, FILE *file);
+
+#endif
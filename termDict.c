@@ -0,0 +1,314 @@
+/* termDict.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * CHD (compress, hash and displace) minimal perfect hash:
+ * 1. Every word gets three hashes: a bucket (about LAMBDA words share
+ *    one) and two values f1, f2 in 0 .. m-1. The table has m = n / LOAD
+ *    slots for n words; with no spare slots at all the last buckets
+ *    can take millions of tries to place.
+ * 2. Buckets are placed largest first. For bucket b the displacements
+ *    d = 0, 1, 2, ... are tried, putting each of its words at
+ *          slot = (f1 + d0 * f2 + d1) mod m     where d = d0 * m + d1
+ *    until all of them land on free slots; d is stored for the bucket.
+ * 3. slot i of the table holds the index offset of the line of the word
+ *    placed there, or -1 for the few slots left empty.
+ * A lookup is one hash, one displacement and one table read; the word on
+ * the line it points to is then compared, as a missing word also maps
+ * to some slot.
+ *
+ * FILE LAYOUT:
+ *  DictHeader
+ *  unsigned int disp[nBuckets]
+ *  long         offset[nSlots]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "termDict.h"
+#include "stats.h"
+#include "fileUtil.h"
+
+#define TRUE            1
+#define FALSE           0
+#define LAMBDA          4       // average words per bucket
+#define LOAD            0.99    // words per table slot
+#define MAX_SEEDS       64
+#define MAX_DISP        (1ULL << 22)    // tries per bucket before a new seed
+#define FNV64_OFFSET    14695981039346656037ULL
+#define FNV64_PRIME     1099511628211ULL
+#define GOLDEN          0x9e3779b97f4a7c15ULL
+#define MAX_NAME        1024
+
+typedef unsigned long long Hash;
+
+typedef struct dictHeader {
+    int          magic;
+    int          nTerms;
+    int          nSlots;
+    int          nBuckets;
+    unsigned int seed;
+    long         indexSize;     // size and modification time of the index
+    long         indexTime;     // it was built from
+} DictHeader;
+
+struct termDict {
+    DictHeader    header;
+    unsigned int *disp;
+    long         *offset;
+};
+
+typedef struct wordHash {
+    int  bucket;
+    Hash f1, f2;
+} WordHash;
+
+
+// splitmix64 finaliser, spreads the bits of h
+static Hash mix(Hash h)
+{
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+
+static WordHash hashWord(char *word, int len, unsigned int seed, int nBuckets, int m)
+{
+    Hash h = FNV64_OFFSET ^ seed;
+    int i;
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)word[i];
+        h *= FNV64_PRIME;
+    }
+    WordHash w;
+    w.bucket = mix(h + GOLDEN) % nBuckets;
+    w.f1 = mix(h + 2 * GOLDEN) % m;
+    w.f2 = mix(h + 3 * GOLDEN) % m;
+    return w;
+}
+
+
+static int slotOf(WordHash *w, Hash d, int m)
+{
+    return (w->f1 + (d / m) * w->f2 + d % m) % m;
+}
+
+
+static FILE *openOrDie(char *fileName, char *mode)
+{
+    FILE *file = fopen(fileName, mode);
+    if (!file) { perror("fopen failed"); exit(EXIT_FAILURE); }
+    return file;
+}
+
+
+/* Reads the whole index into memory and finds its words: word i starts
+ * at offset[i] and is len[i] chars long. Returns the number of words.
+ */
+static int readWords(char *indexName, char **text, long **offset, int **len)
+{
+    FILE *file = openOrDie(indexName, "r");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    *text = malloc(size + 1);
+    assert(*text != NULL);
+    size = fread(*text, 1, size, file);
+    (*text)[size] = '\0';
+    fclose(file);
+
+    int nLines = 0;
+    long i;
+    for (i = 0; i < size; i++) if ((*text)[i] == '\n') nLines++;
+    *offset = malloc((nLines + 1) * sizeof(long));
+    *len = malloc((nLines + 1) * sizeof(int));
+    assert(*offset != NULL && *len != NULL);
+    int n = 0;
+    for (i = 0; i < size; ) {
+        long end = i;
+        while (end < size && (*text)[end] != ' ' && (*text)[end] != '\n') end++;
+        if (end > i) {
+            (*offset)[n] = i;
+            (*len)[n] = end - i;
+            n++;
+        }
+        while (end < size && (*text)[end] != '\n') end++;
+        i = end + 1;
+    }
+    return n;
+}
+
+
+/* Places the n words in the m slots with the given hashes; slotWord[i]
+ * gets the word in slot i or -1. Returns FALSE if some bucket ran out of
+ * displacements, so the caller can try another seed.
+ */
+static int placeBuckets(WordHash *hash, int n, int m, int nBuckets,
+                        unsigned int *disp, int *slotWord)
+{
+    // group the words by bucket (counting sort)
+    int *start = calloc(nBuckets + 1, sizeof(int));
+    int *members = malloc(n * sizeof(int));
+    int *order = malloc(nBuckets * sizeof(int));
+    int *slots = malloc((n + 1) * sizeof(int));
+    assert(start != NULL && members != NULL && order != NULL && slots != NULL);
+    int i, b, k;
+    for (i = 0; i < n; i++) start[hash[i].bucket + 1]++;
+    int maxSize = 0;
+    for (b = 0; b < nBuckets; b++) {
+        if (start[b + 1] > maxSize) maxSize = start[b + 1];
+        start[b + 1] += start[b];
+    }
+    int *fill = malloc((nBuckets + 1) * sizeof(int));
+    assert(fill != NULL);
+    memcpy(fill, start, (nBuckets + 1) * sizeof(int));
+    for (i = 0; i < n; i++) members[fill[hash[i].bucket]++] = i;
+    // largest buckets first, again by counting sort on the size
+    int *bySize = calloc(maxSize + 2, sizeof(int));
+    assert(bySize != NULL);
+    for (b = 0; b < nBuckets; b++) bySize[maxSize - (start[b + 1] - start[b]) + 1]++;
+    for (k = 0; k <= maxSize; k++) bySize[k + 1] += bySize[k];
+    for (b = 0; b < nBuckets; b++) order[bySize[maxSize - (start[b + 1] - start[b])]++] = b;
+
+    for (i = 0; i < m; i++) slotWord[i] = -1;
+    Hash maxDisp = (Hash)m * m < MAX_DISP ? (Hash)m * m : MAX_DISP;
+    int placed = TRUE;
+    for (k = 0; k < nBuckets && placed; k++) {
+        b = order[k];
+        int size = start[b + 1] - start[b];
+        if (size == 0) { disp[b] = 0; continue; }
+        Hash d;
+        for (d = 0; d < maxDisp; d++) {
+            int j, ok = TRUE;
+            for (j = 0; j < size && ok; j++) {
+                int w = members[start[b] + j];
+                slots[j] = slotOf(&hash[w], d, m);
+                if (slotWord[slots[j]] != -1) ok = FALSE;
+                else slotWord[slots[j]] = w;    // claimed, undone on failure
+            }
+            if (ok) break;
+            // release the slots taken before the clash
+            int taken = j - 1;
+            for (j = 0; j < taken; j++) slotWord[slots[j]] = -1;
+        }
+        if (d == maxDisp) placed = FALSE;
+        else disp[b] = d;
+    }
+    free(start); free(members); free(order); free(slots); free(fill); free(bySize);
+    return placed;
+}
+
+
+void buildTermDict(char *indexName, char *dictName)
+{
+    char *text;
+    long *offset;
+    int *len;
+    int n = readWords(indexName, &text, &offset, &len);
+
+    DictHeader header = { DICT_MAGIC, n, n / LOAD + 1, (n + LAMBDA - 1) / LAMBDA, 0, 0, 0 };
+    if (header.nBuckets == 0) header.nBuckets = 1;
+    int m = header.nSlots;
+    fileVersion(indexName, &header.indexSize, &header.indexTime);
+    unsigned int *disp = calloc(header.nBuckets, sizeof(unsigned int));
+    int *slotWord = malloc(m * sizeof(int));
+    WordHash *hash = malloc((n + 1) * sizeof(WordHash));
+    assert(disp != NULL && slotWord != NULL && hash != NULL);
+    int i, placed = n == 0;
+    for (i = 0; i < m; i++) slotWord[i] = -1;
+    for (; !placed && header.seed < MAX_SEEDS; header.seed++) {
+        for (i = 0; i < n; i++)
+            hash[i] = hashWord(text + offset[i], len[i], header.seed, header.nBuckets, m);
+        if (placeBuckets(hash, n, m, header.nBuckets, disp, slotWord)) break;
+    }
+    if (n > 0 && header.seed == MAX_SEEDS) {
+        // only happens with repeated words; searches scan the index instead
+        fprintf(stderr, "could not build %s\n", dictName);
+        remove(dictName);
+    } else {
+        // written under another name and renamed, so a search never reads
+        // half a dictionary
+        char tmpName[MAX_NAME];
+        FILE *file = openTemp(dictName, tmpName, MAX_NAME);
+        fwrite(&header, sizeof(DictHeader), 1, file);
+        fwrite(disp, sizeof(unsigned int), header.nBuckets, file);
+        for (i = 0; i < m; i++) {
+            long slotOffset = slotWord[i] == -1 ? -1 : offset[slotWord[i]];
+            fwrite(&slotOffset, sizeof(long), 1, file);
+        }
+        if (!commitTemp(file, tmpName, dictName)) remove(dictName);
+    }
+    free(text); free(offset); free(len);
+    free(disp); free(slotWord); free(hash);
+}
+
+
+TermDict loadTermDict(char *indexName, char *dictName)
+{
+    FILE *file = statsFopen(dictName, "rb");
+    if (file == NULL) return NULL;
+    TermDict dict = calloc(1, sizeof(struct termDict));
+    assert(dict != NULL);
+    DictHeader *h = &dict->header;
+    long size, time;
+    int valid = fread(h, sizeof(DictHeader), 1, file) == 1
+             && h->magic == DICT_MAGIC && h->nSlots > 0 && h->nBuckets > 0
+             && fileVersion(indexName, &size, &time)
+             && size == h->indexSize && time == h->indexTime;
+    if (valid) {
+        dict->disp = malloc(h->nBuckets * sizeof(unsigned int));
+        dict->offset = malloc(h->nSlots * sizeof(long));
+        assert(dict->disp != NULL && dict->offset != NULL);
+        valid = fread(dict->disp, sizeof(unsigned int), h->nBuckets, file) == h->nBuckets
+             && fread(dict->offset, sizeof(long), h->nSlots, file) == h->nSlots;
+    }
+    STATS_ADD(STAT_BYTES, ftell(file));
+    fclose(file);
+    if (!valid) {
+        freeTermDict(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+
+void freeTermDict(TermDict dict)
+{
+    if (dict == NULL) return;
+    free(dict->disp);
+    free(dict->offset);
+    free(dict);
+}
+
+
+long termDictOffset(TermDict dict, char *word)
+{
+    DictHeader *h = &dict->header;
+    if (h->nTerms == 0) return -1;
+    WordHash w = hashWord(word, strlen(word), h->seed, h->nBuckets, h->nSlots);
+    return dict->offset[slotOf(&w, dict->disp[w.bucket], h->nSlots)];
+}
+
+
+int termDictLine(TermDict dict, FILE *index, char *word, char *line, int lineSize)
+{
+    long offset = termDictOffset(dict, word);
+    if (offset < 0) return FALSE;
+    if (fseek(index, offset, SEEK_SET) != 0) return TERM_STALE;
+    if (statsFgets(line, lineSize, index) == NULL) return TERM_STALE;
+    int len = strlen(word);
+    if (strncmp(line, word, len) == 0 && line[len] == ' ') return TRUE;
+    // a missing word lands on another word's line, which must lead back
+    // here; if it does not, the index has changed under the dictionary
+    char *end = strchr(line, ' ');
+    if (end == NULL) return TERM_STALE;
+    *end = '\0';
+    int stale = termDictOffset(dict, line) != offset;
+    *end = ' ';
+    return stale ? TERM_STALE : FALSE;
+}
@@ -0,0 +1,49 @@
+/* termDict.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Perfect hash over the words of invertedIndex.txt (one table slot per
+ * word plus about 1% spare), built by invertedIndex and stored next to
+ * it in DICT_FILE. It maps a word
+ * straight to the offset of its line in the index, so the search tools
+ * read one line per query word instead of scanning the whole file.
+ */
+
+#ifndef TERMDICT_H
+#define TERMDICT_H
+
+#include <stdio.h>
+
+#define DICT_FILE   "invertedIndex.dict"
+#define DICT_MAGIC  0x31435444  // "DTC1"
+#define TERM_STALE  -1
+
+typedef struct termDict *TermDict;
+
+/* Builds the dictionary for the index file indexName (lines of the form
+ * "word  url url ...") and writes it to dictName.
+ */
+void buildTermDict(char *indexName, char *dictName);
+
+/* Loads dictName for indexName. Returns NULL if there is no dictionary
+ * or it was built for a different version of the index; callers then
+ * fall back to scanning the index.
+ */
+TermDict loadTermDict(char *indexName, char *dictName);
+void freeTermDict(TermDict);
+
+/* Offset in the index file of the only line that can hold word, or -1
+ * if no indexed word hashes there. The caller still has to compare the
+ * word on that line, since words not in the index land on some slot.
+ */
+long termDictOffset(TermDict, char *word);
+
+/* Reads the line for word from index (opened on the dictionary's index
+ * file) into line (lineSize chars). Returns 1 if word is indexed, else 0,
+ * or TERM_STALE if the line found is not one the dictionary points to
+ * (the index was rewritten without it); callers then scan the index.
+ */
+int termDictLine(TermDict, FILE *index, char *word, char *line, int lineSize);
+
+#endif
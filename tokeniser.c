@@ -0,0 +1,148 @@
+/* tokeniser.c
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ *
+ * The text is copied into the buffer 16 bytes at a time (32 with AVX2).
+ * The same pass folds A-Z to lowercase in-register: two signed compares
+ * give a mask of the capitals, and 0x20 is OR-ed in under that mask.
+ * It also collects a bit mask of the spaces. The word boundaries are
+ * then read off that mask a set bit at a time. Only the few bytes at
+ * either end of a word are looked at one by one (trim and the trailing
+ * punctuation), and each word is NUL-terminated in place.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "tokeniser.h"
+#include "stats.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define INIT_TEXT   1024
+#define INIT_TOKENS 256
+
+
+TokenBuffer newTokenBuffer()
+{
+    TokenBuffer buf = calloc(1, sizeof(struct tokenBuffer));
+    assert(buf != NULL);
+    return buf;
+}
+
+
+void freeTokenBuffer(TokenBuffer buf)
+{
+    if (buf == NULL) return;
+    free(buf->text);
+    free(buf->start);
+    free(buf->len);
+    free(buf);
+}
+
+
+// white space other than ' ' that trim() removes
+static int isOtherSpace(char c)
+{
+    return c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+
+static int isEndPunct(char c)
+{
+    return c == '.' || c == '?' || c == ',' || c == ';';
+}
+
+
+static char lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c | 0x20 : c;
+}
+
+
+// adds the piece text[from .. to) as a word, normalising it in place
+static void addToken(TokenBuffer buf, int from, int to)
+{
+    char *text = buf->text;
+    while (from < to && isOtherSpace(text[from])) from++;
+    while (to > from && isOtherSpace(text[to - 1])) to--;
+    if (to > from && isEndPunct(text[to - 1])) to--;
+    if (buf->nTokens == buf->capTokens) {
+        buf->capTokens = buf->capTokens == 0 ? INIT_TOKENS : buf->capTokens * 2;
+        buf->start = realloc(buf->start, buf->capTokens * sizeof(int));
+        buf->len = realloc(buf->len, buf->capTokens * sizeof(int));
+        assert(buf->start != NULL && buf->len != NULL);
+    }
+    buf->start[buf->nTokens] = from;
+    buf->len[buf->nTokens] = to - from;
+    buf->nTokens++;
+    text[to] = '\0';
+}
+
+
+int tokeniseText(TokenBuffer buf, char *text)
+{
+    int n = strlen(text);
+    if (n + 1 > buf->capText) {
+        buf->capText = n + 1 > INIT_TEXT ? n + 1 : INIT_TEXT;
+        free(buf->text);
+        buf->text = malloc(buf->capText);
+        assert(buf->text != NULL);
+    }
+    char *out = buf->text;
+    buf->nTokens = 0;
+    int pos = 0, wordStart = 0;
+#if defined(__AVX2__)
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i beforeA = _mm256_set1_epi8('A' - 1);
+    const __m256i afterZ = _mm256_set1_epi8('Z' + 1);
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    for (; pos + 32 <= n; pos += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(text + pos));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, beforeA),
+                                         _mm256_cmpgt_epi8(afterZ, c));
+        c = _mm256_or_si256(c, _mm256_and_si256(upper, caseBit));
+        _mm256_storeu_si256((__m256i *)(out + pos), c);
+        unsigned spaces = _mm256_movemask_epi8(_mm256_cmpeq_epi8(c, space));
+        while (spaces != 0) {
+            int at = pos + __builtin_ctz(spaces);
+            if (at > wordStart) addToken(buf, wordStart, at);
+            wordStart = at + 1;
+            spaces &= spaces - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; pos + 16 <= n; pos += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(text + pos));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, beforeA),
+                                      _mm_cmpgt_epi8(afterZ, c));
+        c = _mm_or_si128(c, _mm_and_si128(upper, caseBit));
+        _mm_storeu_si128((__m128i *)(out + pos), c);
+        unsigned spaces = _mm_movemask_epi8(_mm_cmpeq_epi8(c, space));
+        while (spaces != 0) {
+            int at = pos + __builtin_ctz(spaces);
+            if (at > wordStart) addToken(buf, wordStart, at);
+            wordStart = at + 1;
+            spaces &= spaces - 1;
+        }
+    }
+#endif
+    for (; pos < n; pos++) {
+        out[pos] = lower(text[pos]);
+        if (out[pos] != ' ') continue;
+        if (pos > wordStart) addToken(buf, wordStart, pos);
+        wordStart = pos + 1;
+    }
+    out[n] = '\0';
+    if (n > wordStart) addToken(buf, wordStart, n);
+    STATS_ADD(STAT_TOKENS, buf->nTokens);
+    return buf->nTokens;
+}
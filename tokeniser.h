@@ -0,0 +1,34 @@
+/* tokeniser.h
+ *
+ * Written by Selina (z5208109) & Yasmin (z5207093)
+ * Group: duckduckgo
+ * Description:
+ * Splits page text into normalised words without allocating per word.
+ * Words are what strsep(&text, " ") followed by normalise() gives:
+ * split on spaces, trimmed of other white space, lowercased (A-Z only)
+ * and with one trailing '.', '?', ',' or ';' removed.
+ */
+
+#ifndef TOKENISER_H
+#define TOKENISER_H
+
+typedef struct tokenBuffer *TokenBuffer;
+
+struct tokenBuffer {
+    char *text;         // lowercased copy of the text, words NUL-terminated
+    int   capText;
+    int  *start;        // word i is text + start[i], len[i] chars long
+    int  *len;
+    int   nTokens;
+    int   capTokens;
+};
+
+TokenBuffer newTokenBuffer();
+void freeTokenBuffer(TokenBuffer);
+/* Tokenises text into the buffer, reusing its memory. Returns the number
+ * of words, counting the non-empty pieces between spaces that normalise
+ * to the empty string (len 0) as well.
+ */
+int tokeniseText(TokenBuffer, char *text);
+
+#endif